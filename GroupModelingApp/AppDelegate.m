@@ -10,6 +10,9 @@
 #import "Constants.h"
 #import <DBChooser/DBChooser.h>
 #import "EventLogger.h"
+#import "Model.h"
+#import "ModelBenchmark.h"
+#import "ModelJournal.h"
 #import "SideMenuViewController.h"
 #import "ModelSectionViewController.h"
 #import <Parse/Parse.h>
@@ -30,6 +33,16 @@
     
     [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID: APP_LOADED]];
     
+    // Bring back the model that was open when the app was last closed, once the model view has been laid out.
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [[Model sharedModel].journal restoreModel];
+    });
+    
+#ifdef DEBUG
+    // Time the import and export of a model when launched with -benchmarkFile <path>.
+    [ModelBenchmark runFromLaunchArguments];
+#endif
+    
     // Register notifications for device orientation.
     [[UIDevice currentDevice] beginGeneratingDeviceOrientationNotifications];
     [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(detectOrientation) name:@"UIDeviceOrientationDidChangeNotification" object:nil];
@@ -61,6 +74,7 @@
 {
     // Use this method to release shared resources, save user data, invalidate timers, and store enough application state information to restore your application to its current state in case it is terminated later. 
     // If your application supports background execution, this method is called instead of applicationWillTerminate: when the user quits.
+    [[ModelJournal sharedModelJournal] flushAndWait];
     [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID: APP_ENTERED_BACKGROUND]];
 }
 
@@ -84,6 +98,7 @@
 - (void)applicationWillTerminate:(UIApplication *)application
 {
     // Called when the application is about to terminate. Save data if appropriate. See also applicationDidEnterBackground:.
+    [[ModelJournal sharedModelJournal] flushAndWait];
     [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID: APP_TERMINATED]];
 }
 
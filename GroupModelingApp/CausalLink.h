@@ -8,6 +8,8 @@
 
 #import "CausalLinkView.h"
 #import "Component.h"
+#import "ComponentRecord.h"
+#import "RecordBuilder.h"
 #import "Variable.h"
 
 /// A subclass of Component containing the data related to a causal link between two variables of a causal loop diagram. ex. In a diagram on Childhood obesity, there may exist a relationship between the "Fast Food Consumption" variable and the "Weight Gain" variable.  This class represents that causal link.
@@ -22,13 +24,22 @@
 /// The UIView that will contain the graphical representation of the causal link.
 @property CausalLinkView* view;
 
--(id)init:(NSArray*)data;
+/// Whether the arc was read from an archive, so createView does not need to calculate it.
+@property bool isArcPrecomputed;
+
+-(id)initWithRecord:(ComponentRecord*)record;
 
 -(id) initWithParent:(Variable*)parent andChild:(Variable*) child;
 
 -(void)createView;
+-(ComponentRecord*)createRecord;
+-(void)applyRecord:(ComponentRecord*)record;
++(bool)getVensimColor:(UIColor*)color red:(int*)red green:(int*)green blue:(int*)blue;
+
+-(void)logImport;
 
 -(NSString*) createCausalLinkOutputString;
+-(void) appendCausalLinkOutputTo:(RecordBuilder*)builder;
 
 -(UIColor*)convertToUIColor:(int) red andGreen:(int) green andBlue:(int) blue;
 
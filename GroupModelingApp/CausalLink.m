@@ -14,85 +14,56 @@
 
 @implementation CausalLink
 
-/// Enum containing the indicies of an array of strings separated by commas in which the different attributes of a causal link in a Vensim mdl file are located.
-enum IndexLocations
-{
-    TYPE              = 0,
-    ID                = 1,
-    PARENT            = 2,
-    CHILD             = 3,
-    POLARITY          = 6,
-    LINE_THICKNESS    = 7,
-    DELAY             = 9,
-    ARC_COLOR         = 11,
-    XCOORD            = 13,
-    YCOORD            = 14
-};
-
 @synthesize parentObject     = _parentObject;
 @synthesize childObject      = _childObject;
 @synthesize view             = _view;
+@synthesize isArcPrecomputed = _isArcPrecomputed;
 
 /// Initializes the CausalLink.
-/// @param data an array of strings containing all of the data for the causal link from a Vensim mdl file.
+/// @param record the data for the causal link from a Vensim mdl file.
 /// @return a pointer to the newly created causal link.
--(id)init:(NSArray*)data
+-(id)initWithRecord:(ComponentRecord*)record
 {
-    self = [super init];
+    self = [super initWithIDNum:record.idNum];
     if(self)
     {
-        self.objectType       = [[data objectAtIndex:TYPE] integerValue];
-        self.idNum            = [[data objectAtIndex:ID] integerValue];
+        self.objectType       = record.objectType;
         
-        /// The parent and child objects will point to integers initially. Once the entire model is parsed, the FileIO class will update these objects to point to the associated variable objects.
-        self.parentObject     = [[NSNumber alloc]initWithInt:[[data objectAtIndex:PARENT]integerValue]];
-        self.childObject      = [[NSNumber alloc]initWithInt:[[data objectAtIndex:CHILD]integerValue]];
+        /// The parent and child objects will point to integers initially. Once the entire model is parsed, the Model will update these objects to point to the associated variable objects.
+        self.parentObject     = [[NSNumber alloc]initWithInt:record.parentID];
+        self.childObject      = [[NSNumber alloc]initWithInt:record.childID];
         
         // The line below will be how we handle the view initially.  Setting frame and starting, ending, and control points will be handled in the create view method.
         self.view = [[CausalLinkView  alloc] initWithParent:self];
         
         
         // The view holds the polarity value.
-        int polarity = [[data objectAtIndex:POLARITY] integerValue];
-        [self.view setPolarity: (polarity == PLUS) ? PLUS_SYMBOL : MINUS_SYMBOL];
+        [self.view setPolarity: (record.polarity == PLUS) ? PLUS_SYMBOL : MINUS_SYMBOL];
         
         // The view holds the line thickness.
-        int lineThickness = [[data objectAtIndex:LINE_THICKNESS] integerValue];
-        [self.view setIsBold:(lineThickness == NORMAL)?  NO : YES];
+        [self.view setIsBold:(record.lineThickness == NORMAL)?  NO : YES];
         
         // The view holds the time delay value.
-        int delayVal = [[data objectAtIndex:DELAY]integerValue];
-        // There are four different situations where time delay can exist.
-        if( delayVal == TIME_DELAY1 || delayVal == TIME_DELAY2 || delayVal == TIME_DELAY3 || delayVal == TIME_DELAY4)
-        {
-            [self.view setHasTimeDelay:YES];
-        }
+        [self.view setHasTimeDelay:[record hasTimeDelay]];
+        
+        // The arc color will be black when the record uses the Vensim default color.
+        if(record.hasColor)
+            self.view.arcColor = [self convertToUIColor:record.red andGreen:record.green andBlue:record.blue];
         else
+            self.view.arcColor = [UIColor blackColor];
+        
+        // Turns out vensim stores the handles location not the center point. Although we can still use this point to create some initial arc.
+        // A record from an archive already holds the arc, so it is used as is.
+        if(record.hasArc)
         {
-            [self.view setHasTimeDelay:NO];
+            [self.view setVertexPoint:CGPointMake(record.vertexX, record.vertexY)];
+            [self.view setControlPoint:CGPointMake(record.controlX, record.controlY)];
+            self.isArcPrecomputed = YES;
         }
-        
-        // The arc color will be in the format R-G-B
-        NSString* rgb =[data objectAtIndex:ARC_COLOR];
-        
-        // the default ouptut from vensim
-        if([rgb isEqualToString:DEFAULT_LINK_COLOR])
-            self.view.arcColor = [UIColor blackColor];
         else
         {
-            int red   = [[[rgb componentsSeparatedByString:@"-"] objectAtIndex:0] integerValue];
-            int green = [[[rgb componentsSeparatedByString:@"-"] objectAtIndex:1] integerValue];
-            int blue  = [[[rgb componentsSeparatedByString:@"-"] objectAtIndex:2] integerValue];
-            
-            self.view.arcColor = [self convertToUIColor:red andGreen:green andBlue:blue];
+            [self.view setVertexPoint:CGPointMake(record.xcoord, record.ycoord)];
         }
-        
-        // Turns out vensim stores the handles location not the center point. Although we can still use this point to create some initial arc.
-        // The X coord string will be in a format like: 1|(###
-        int xcoord = [[[[data objectAtIndex:XCOORD] componentsSeparatedByString:@"("]objectAtIndex:1] integerValue];
-        // The Y coord string will be in a format like: ###)|
-        int ycoord = [[[[data objectAtIndex:YCOORD] componentsSeparatedByString:@")"]objectAtIndex:0] integerValue];
-        [self.view setVertexPoint:CGPointMake(xcoord, ycoord)];
     }
     return self;
 }
@@ -125,22 +96,14 @@ enum IndexLocations
   
         // Determine the appropriate frame for this view.
         [self.view calculateFrame];
-    
-        // Add the view and redisplay.
-        // Get the root view controller view and add the Variable's view as a subview.
-        UIView* parentView = [[Model sharedModel] getViewControllerView];
-    
-        [parentView insertSubview:self.view atIndex:0];
-        [parentView setNeedsDisplay];
     }
     
     return self;
 }
 
-/// When initially importing the file, a CausalLink does not know the location of its parent and child, but knows the id of the parent and child.  Once the file has been parsed through completely, FileIO will revisit the CausalLinks and set the parentObject and the childObject to the corresponding Variable instances.
+/// When initially importing the file, a CausalLink does not know the location of its parent and child, but knows the id of the parent and child.  Once the file has been parsed through completely, the Model will revisit the CausalLinks and set the parentObject and the childObject to the corresponding Variable instances.
 /// This method updates the startPoint, endPoint, controlPoint located in the view based on the updated parent and child objects.
-/// After the points of the arc have been set, the frame of the view will be calculated and the view will be added to the parentview.
-/// @param parentView the superview that the CausalLink view will be added as a subview.
+/// After the points of the arc have been set, the frame of the view will be calculated.  The Model adds the view to the parentview along with the rest of the imported components.
 -(void) createView
 {
     CGPoint parentCenter = [[self.parentObject view]center];
@@ -159,24 +122,92 @@ enum IndexLocations
                                            childCenter.y)];
     }
     
-    // Update the control point now that we know where the origin is located.
-    [self.view setVertexPoint:CGPointMake([self.view vertexPoint].x - self.view.frame.origin.x,
-                                           [self.view vertexPoint].y - self.view.frame.origin.y)];
-    
-    // Call this calculate to ensure that the control point is aligned with the vertex.
-    [self.view calculateInitialArc];
+    // The arc of a link read from an archive was calculated when it was saved.
+    if(!self.isArcPrecomputed)
+    {
+        // Update the control point now that we know where the origin is located.
+        [self.view setVertexPoint:CGPointMake([self.view vertexPoint].x - self.view.frame.origin.x,
+                                               [self.view vertexPoint].y - self.view.frame.origin.y)];
+        
+        // Call this calculate to ensure that the control point is aligned with the vertex.
+        [self.view calculateInitialArc];
+    }
+    self.isArcPrecomputed = NO;
 
     // Determine the appropriate frame for this view.
     [self.view calculateFrame];
+}
+
+/// Creates a record of the current state of the CausalLink that initWithRecord: turns back into the same CausalLink.
+/// The location stored is the location of the handle, the same as in a Vensim mdl file.
+/// @return the record of the causal link.
+-(ComponentRecord*)createRecord
+{
+    ComponentRecord* record = [[ComponentRecord alloc] init];
+    record.objectType    = CAUSAL_LINK;
+    record.idNum         = self.idNum;
+    record.name          = @"";
+    record.parentID      = [self.parentObject idNum];
+    record.childID       = [self.childObject idNum];
+    record.polarity      = ([self.view.polarity isEqualToString:PLUS_SYMBOL]) ? PLUS : MINUS;
+    record.lineThickness = (self.view.isBold) ? LIGHT_BOLD : NORMAL;
+    record.delay         = (self.view.hasTimeDelay) ? TIME_DELAY1 : 0;
+    record.xcoord        = (int)self.view.vertexPoint.x + (int)self.view.frame.origin.x;
+    record.ycoord        = (int)self.view.vertexPoint.y + (int)self.view.frame.origin.y;
     
-    // Add the view and redisplay.
-    // Get the root view controller view and add the Variable's view as a subview.
-    UIView* parentView = [[Model sharedModel] getViewControllerView];
+    // The points of the arc are stored relative to the view, the record holds them in the coordinates of the model view.
+    record.hasArc        = YES;
+    record.controlX      = self.view.controlPoint.x + self.view.frame.origin.x;
+    record.controlY      = self.view.controlPoint.y + self.view.frame.origin.y;
+    record.vertexX       = self.view.vertexPoint.x + self.view.frame.origin.x;
+    record.vertexY       = self.view.vertexPoint.y + self.view.frame.origin.y;
     
-    [parentView insertSubview:self.view atIndex:0];
-    [parentView setNeedsDisplay];
+    int red, green, blue;
+    record.hasColor = [CausalLink getVensimColor:self.view.arcColor red:&red green:&green blue:&blue];
+    record.red      = red;
+    record.green    = green;
+    record.blue     = blue;
+    return record;
+}
+
+/// Sets the CausalLink to the state held by a record, keeping its view and its place in the model.  Used when an edit is undone or redone.
+/// The parent and child are not changed, so the Variables of the link must already be where the record expects them.
+/// @param record the record of the causal link, created by createRecord.
+-(void)applyRecord:(ComponentRecord*)record
+{
+    [self.view setPolarity:(record.polarity == PLUS) ? PLUS_SYMBOL : MINUS_SYMBOL];
+    [self.view setIsBold:(record.lineThickness == NORMAL) ? NO : YES];
+    [self.view setHasTimeDelay:[record hasTimeDelay]];
+    if(record.hasColor)
+        self.view.arcColor = [self convertToUIColor:record.red andGreen:record.green andBlue:record.blue];
+    else
+        self.view.arcColor = [UIColor blackColor];
     
-    // Log the import
+    // The points of the arc are relative to the view, the record and the Variables hold them in the coordinates of the model view.
+    CGPoint origin       = self.view.frame.origin;
+    CGPoint parentCenter = [[self.parentObject view]center];
+    CGPoint childCenter  = [[self.childObject view]center];
+    [self.view setStartPoint:CGPointMake(parentCenter.x - origin.x, parentCenter.y - origin.y)];
+    [self.view setEndPoint:CGPointMake(childCenter.x - origin.x, childCenter.y - origin.y)];
+    if(record.hasArc)
+    {
+        [self.view setVertexPoint:CGPointMake(record.vertexX - origin.x, record.vertexY - origin.y)];
+        [self.view setControlPoint:CGPointMake(record.controlX - origin.x, record.controlY - origin.y)];
+    }
+    else
+    {
+        [self.view setVertexPoint:CGPointMake(record.xcoord - origin.x, record.ycoord - origin.y)];
+        [self.view calculateInitialArc];
+    }
+    
+    [self.view calculateFrame];
+    [self.view setNeedsDisplay];
+}
+
+/// Logs the import of the CausalLink with a formatted description of its parent, child, polarity, thickness, time delay, and color.
+/// Only used when the event logger is recording imports in verbose mode.
+-(void) logImport
+{
     NSString* parentChild = [NSString stringWithFormat:PARENT_CHILD, [(Variable*)self.parentObject view].name,
                                                                      [(Variable*)self.parentObject idNum],
                                                                      [(Variable*)self.childObject view].name,
@@ -199,58 +230,67 @@ enum IndexLocations
 /// [Object Type],[Object id], [Starting Object id],[Ending Object id],1,0,[Polarity],[Line thickness],3,[Delay/Polarity Position],0,[Arrow Color],[Font Size],[Font Color],[Handle Position]
 /// @return the Vensim string of data for the CausalLink.
 -(NSString*) createCausalLinkOutputString
+{
+    RecordBuilder* builder = [[RecordBuilder alloc] init];
+    [self appendCausalLinkOutputTo:builder];
+    return [builder string];
+}
+
+/// Appends the output record for a CausalLink to a RecordBuilder.
+/// @see createCausalLinkOutputString for the pattern of the record.
+/// @param builder the builder to append the record to.
+-(void) appendCausalLinkOutputTo:(RecordBuilder*)builder
 {
     // Initialize with the type.
-    NSString* result = [NSString stringWithFormat:@"%d", CAUSAL_LINK];
+    [builder appendInt:CAUSAL_LINK];
     
     // Add the id number.
-    result = [result stringByAppendingString:[NSString stringWithFormat:@",%d", self.idNum]];
+    [builder appendField:self.idNum];
     
     // Add the parent id.
-    result = [result stringByAppendingString:[NSString stringWithFormat:@",%d",[self.parentObject idNum]]];
+    [builder appendField:[self.parentObject idNum]];
 
     // Add the child id.
-    result = [result stringByAppendingString:[NSString stringWithFormat:@",%d",[self.childObject idNum]]];
+    [builder appendField:[self.childObject idNum]];
     
     // Add misc. defaults.
-    result = [result stringByAppendingString:CAUSAL_LINK_DEFAULTS1];
+    [builder appendString:CAUSAL_LINK_DEFAULTS1];
     
     // Add the polarity.
     if([self.view.polarity isEqualToString:PLUS_SYMBOL])
-        result = [result stringByAppendingString:[NSString stringWithFormat:@",%d",PLUS]];
+        [builder appendField:PLUS];
     else
-        result = [result stringByAppendingString:[NSString stringWithFormat:@",%d",MINUS]];
+        [builder appendField:MINUS];
     
     // Add the line thickness
     if(self.view.isBold)
-        result = [result stringByAppendingString:[NSString stringWithFormat:@",%d",LIGHT_BOLD]];
+        [builder appendField:LIGHT_BOLD];
     else
-        result = [result stringByAppendingString:[NSString stringWithFormat:@",%d",NORMAL]];
+        [builder appendField:NORMAL];
     
     // Add the ability to export color.
-    result = [result stringByAppendingString:COLOR_ON];
+    [builder appendString:COLOR_ON];
     
     // Add the time delay /polarity position. By default I do not care what the polarity position is.
-    result = [result stringByAppendingString:[NSString stringWithFormat:@",%d",self.view.hasTimeDelay]];
+    [builder appendField:self.view.hasTimeDelay];
     
     // Character with unknown meaning.
-    result = [result stringByAppendingString:UNKNOWN_CHAR];
+    [builder appendString:UNKNOWN_CHAR];
     
     // Add causal link color.
-    result = [result stringByAppendingString:[self convertFromUIColor:self.view.arcColor]];
+    [builder appendString:[self convertFromUIColor:self.view.arcColor]];
     
     // Add font size.
-    result = [result stringByAppendingString:DEFAULT_LINK_FONT_SIZE];
+    [builder appendString:DEFAULT_LINK_FONT_SIZE];
     
     // Add font color.
-    result = [result stringByAppendingString:DEFAULT_LINK_FONT_COLOR];
+    [builder appendString:DEFAULT_LINK_FONT_COLOR];
     
     // Add the handle position.
-    result = [result stringByAppendingString:[NSString stringWithFormat:@"%@%d,%d%@", BAR_PAREN,
-                                              (int)self.view.vertexPoint.x + (int)self.view.frame.origin.x,
-                                              (int)self.view.vertexPoint.y + (int)self.view.frame.origin.y,
-                                              PAREN_BAR]];
-    return result;
+    [builder appendString:BAR_PAREN];
+    [builder appendInt:(int)self.view.vertexPoint.x + (int)self.view.frame.origin.x];
+    [builder appendField:(int)self.view.vertexPoint.y + (int)self.view.frame.origin.y];
+    [builder appendString:PAREN_BAR];
 }
 
 /// Converts an RGB value to a UIColor.  The RGB values used in the code are the RGB equivalent of colors used in Vensim.
@@ -330,6 +370,32 @@ enum IndexLocations
     return colorName;
 }
 
+/// Converts a UIColor to the RGB values Vensim uses for it.  The inverse of convertToUIColor:andGreen:andBlue:.
+/// @param color the color of a causal link.
+/// @param red set to the red value from 0-255.
+/// @param green set to the green value from 0-255.
+/// @param blue set to the blue value from 0-255.
+/// @return false if the color is black, which is stored as the Vensim default color.
++(bool)getVensimColor:(UIColor*)color red:(int*)red green:(int*)green blue:(int*)blue
+{
+    *red = *green = *blue = 0;
+    if([color isEqual:[UIColor redColor]])
+        *red = 255;
+    else if([color isEqual:[UIColor greenColor]])
+        *green = 255;
+    else if([color isEqual:[UIColor blueColor]])
+        *blue = 255;
+    else if([color isEqual:[UIColor orangeColor]])
+    {
+        *red   = 255;
+        *green = 128;
+    }
+    else
+        return false;
+    
+    return true;
+}
+
 /// Gets the textual representation of a color.
 /// @param color the uicolor that you want to get the name of.
 /// @return the name of the color as a string.
@@ -58,12 +58,16 @@
     CGContextDrawPath(ctx, kCGPathFillStroke);
 }
 
-/// Logs event at the beginning of moving the link.
+/// Logs event at the beginning of moving the link, and opens an undo step for the new shape of the link.
 /// @param touches the set of touch events registered by the application.
 /// @param event the UIEvent that fired the the method call.
 -(void)touchesBegan:(NSSet *)touches withEvent:(UIEvent *)event
 {
     CausalLinkView* view = (CausalLinkView*)self.parent;
+    UndoHistory* history = [Model sharedModel].history;
+    [history beginStep];
+    [history willChangeComponent:(CausalLink*)view.parent];
+    
     // Using vertex point as opposed to touches, because the causal links do not follow the touch but move towards the at direction.
     CGPoint point = CGPointMake(self.parent.vertexPoint.x + self.parent.frame.origin.x,
                                 self.parent.vertexPoint.y + self.parent.frame.origin.y);
@@ -97,7 +101,7 @@
                                                                 andDetails:[[Model sharedModel] constructLocationDetails:point]]];
 }
 
-/// Logs event at the end of moving the link.
+/// Logs event at the end of moving the link, and closes the undo step of the new shape.
 /// @param touches the set of touch events registered by the application.
 /// @param event the UIEvent that fired the the method call.
 -(void)touchesEnded:(NSSet *)touches withEvent:(UIEvent *)event
@@ -110,6 +114,16 @@
      [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID:END_LINK_MOVE
                                                                 andObjectID:[(CausalLink*)view.parent idNum]
                                                                  andDetails:[[Model sharedModel] constructLocationDetails:point]]];
+    [[Model sharedModel].history endStepWithDescID:END_LINK_MOVE andObjectID:[(CausalLink*)view.parent idNum]];
+}
+
+/// Closes the undo step of the new shape when the touch is taken over by a gesture, such as a tap.  A step that did not reshape the link is dropped.
+/// @param touches the set of touch events registered by the application.
+/// @param event the UIEvent that fired the the method call.
+-(void)touchesCancelled:(NSSet *)touches withEvent:(UIEvent *)event
+{
+    CausalLinkView* view = (CausalLinkView*)self.parent;
+    [[Model sharedModel].history endStepWithDescID:END_LINK_MOVE andObjectID:[(CausalLink*)view.parent idNum]];
 }
 
 
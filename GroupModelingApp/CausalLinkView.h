@@ -12,13 +12,13 @@
 @interface CausalLinkView : UIView
 
 /// The color of the arc.
-@property UIColor* arcColor;
+@property (nonatomic) UIColor* arcColor;
 
 /// If the arc is bolded or not.
-@property bool isBold;
+@property (nonatomic) bool isBold;
 
 /// If the arc has a time delay.
-@property bool hasTimeDelay;
+@property (nonatomic) bool hasTimeDelay;
 
 /// The point at which the shape of the arc is controlled.
 @property CGPoint controlPoint;
@@ -30,13 +30,13 @@
 @property CGPoint endPoint;
 
 /// The vertex point of the arc.
-@property CGPoint vertexPoint;
+@property (nonatomic) CGPoint vertexPoint;
 
 /// Pointer to the parent of this view.
 @property id parent;
 
 /// The type of causal link.  + means that as one variable increases, so does the other. (ex. as a child eats more fast food, that child will gain more weight)  - means that as one variable increases, the other variable decreases. (ex. as a child eats healthier, the less weight gain will occur)
-@property NSString* polarity;
+@property (nonatomic) NSString* polarity;
 
 /// The slope in the x direction of the vertex point.
 @property float xSlopeChange;
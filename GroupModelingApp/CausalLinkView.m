@@ -11,6 +11,7 @@
 #import "Constants.h"
 #import "Model.h"
 #import "ModelSectionViewController.h"
+#import "CausalLink.h"
 #import "Variable.h"
 
 @implementation CausalLinkView
@@ -62,6 +63,54 @@
     [self addSubview:handleView];
 }
 
+/// Sets the color of the link.  Part of the sketch record of the causal link.
+/// @param arcColor the new color of the link.
+-(void)setArcColor:(UIColor*)arcColor
+{
+    _arcColor = arcColor;
+    [(CausalLink*)self.parent invalidateRecord];
+}
+
+/// Sets whether the link is bold.  Part of the sketch record of the causal link.
+/// @param isBold true if the link is bold.
+-(void)setIsBold:(bool)isBold
+{
+    _isBold = isBold;
+    [(CausalLink*)self.parent invalidateRecord];
+}
+
+/// Sets whether the link has a time delay.  Part of the sketch record of the causal link.
+/// @param hasTimeDelay true if the link has a time delay.
+-(void)setHasTimeDelay:(bool)hasTimeDelay
+{
+    _hasTimeDelay = hasTimeDelay;
+    [(CausalLink*)self.parent invalidateRecord];
+}
+
+/// Sets the polarity of the link.  Part of the sketch record of the causal link.
+/// @param polarity the new polarity symbol.
+-(void)setPolarity:(NSString*)polarity
+{
+    _polarity = polarity;
+    [(CausalLink*)self.parent invalidateRecord];
+}
+
+/// Sets the location of the handle within the view.  Together with the frame it is part of the sketch record of the causal link.
+/// @param vertexPoint the new location of the handle.
+-(void)setVertexPoint:(CGPoint)vertexPoint
+{
+    _vertexPoint = vertexPoint;
+    [(CausalLink*)self.parent invalidateRecord];
+}
+
+/// Moves or resizes the view.  The origin of the frame is part of the location of the handle in the sketch record.  This is an overridden method.
+/// @param frame the new frame of the view.
+-(void)setFrame:(CGRect)frame
+{
+    [super setFrame:frame];
+    [(CausalLink*)self.parent invalidateRecord];
+}
+
 /// Draws the receiver’s image within the passed-in rectangle.  This is an overridden method.
 /// @param rect the frame of the view in which objects can be drawn.
 - (void)drawRect:(CGRect)rect
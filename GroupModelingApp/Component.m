@@ -7,57 +7,46 @@
 //
 
 #import "Component.h"
+#import "ComponentRecord.h"
 #import "Constants.h"
+#import "Model.h"
 
 @implementation Component
 
 @synthesize idNum       = _idNum;
 @synthesize objectType  = _objectType;
-static int idIter = 0;
+@synthesize model       = _model;
+@synthesize cachedRecord = _cachedRecord;
 
-/// Initialize the Component.
-/// This init contains default values that will be overwritten by the subclasses for any object imported from a Vensim mdl file.
-/// For imported objects, the generated id should be the same value as the one read in from the file.  For any user created object, the idNum will not be overwritten from this init.
-/// @return the unique id for the component.
+/// Initialize a Component created by the user.  It is given the next id of the model it is added to.
+/// @return a pointer to the newly created component.
 -(id)init
+{
+    return [self initWithIDNum:0];
+}
+
+/// Initialize a Component with an id that was already assigned, such as one read in from a Vensim mdl file.
+/// This init contains default values that will be overwritten by the subclasses.
+/// @param idNum the id of the component.
+/// @return a pointer to the newly created component.
+-(id)initWithIDNum:(int)idNum
 {
     self = [super init];
     if(self)
     {
-        self.idNum        = [Component generateID];
+        self.idNum        = idNum;
         self.objectType   = VARIABLE;
     }
     
     return self;
 }
 
-/// Called for every subclass instance to keep track of how many objects there are currently in the model.
-/// The main use of this method will be to generate identification numbers for newly created objects by the user.
-/// Should only be called once by the component model in the init.
-/// @return the unique id for the component.
-+(int)generateID
+/// Discards the cached sketch and archive records so that they are rebuilt on the next export.
+/// Called by the views whenever a property that is part of the record changes, so the change is also recorded in the journal of the model.
+-(void)invalidateRecord
 {
-    return ++idIter;
-}
-
-/// Called to set the id counter back to zero when either a new file is created or opened.
-+(void)resetIDCounter
-{
-    idIter = 0;
-}
-
-/// Returns the largest id number.
-/// @return the largest id number which will be the value of idIter.
-+(int) getLargestIDNum
-{
-    return  idIter;
-}
-
-/// Sets the idIter to the current largest id num on import.
-/// @param num the largest id number.
-+(void) setLargestIDNum:(int)num
-{
-    idIter = num;
+    self.cachedRecord = nil;
+    [self.model componentChanged:self];
 }
 
 /// Used to sanitize strings that may contain extraneous escape characters.
@@ -65,11 +54,7 @@ static int idIter = 0;
 /// @return a string that does not contain any extra backslashes or double-quotes.
 +(NSString*) sanitizeString:(NSString*)str
 {
-    NSString* tempString = str;
-    tempString = [tempString stringByReplacingOccurrencesOfString:@"\\" withString:@""];
-    tempString = [tempString stringByReplacingOccurrencesOfString:@"\"\"" withString:@"\""];
-    
-    return tempString;
+    return [ComponentRecord sanitizeString:str];
 }
 
 @end
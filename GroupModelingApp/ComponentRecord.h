@@ -0,0 +1,84 @@
+//
+//  ComponentRecord.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "RecordScanner.h"
+
+/// The attributes of a single Variable, CausalLink, or Loop as read from a Vensim mdl file.
+/// A ComponentRecord only contains data and has no knowledge of views, so it can be created on any thread and without a UI.
+/// The Model turns records into components with views once the whole file has been read.
+@interface ComponentRecord : NSObject
+
+/// The type of the component.  Should be a Variable = 10, CausalLink = 1, or a Loop = 12.
+@property int objectType;
+
+/// The id number of the component in the model.
+@property int idNum;
+
+/// The name of a Variable or Loop, with escape characters sanitized.  Empty for a CausalLink.
+@property NSString* name;
+
+/// The x location of a Variable or Loop.  For a CausalLink this is the x location of its handle.
+@property int xcoord;
+
+/// The y location of a Variable or Loop.  For a CausalLink this is the y location of its handle.
+@property int ycoord;
+
+/// The symbol of the component.  Whether a Variable is boxed or which direction a Loop points.
+@property int symbol;
+
+/// Where the text holding the name is located in relation to the object.
+@property int textPosition;
+
+/// The id of the Variable a CausalLink starts from.
+@property int parentID;
+
+/// The id of the Variable a CausalLink points to.
+@property int childID;
+
+/// The Vensim value of the polarity of a CausalLink.
+@property int polarity;
+
+/// The Vensim value of the line thickness of a CausalLink.
+@property int lineThickness;
+
+/// The Vensim value of the time delay and polarity position of a CausalLink.
+@property int delay;
+
+/// Whether a CausalLink has a color other than the Vensim default.
+@property bool hasColor;
+
+/// The red value of the color of a CausalLink from 0-255.
+@property int red;
+
+/// The green value of the color of a CausalLink from 0-255.
+@property int green;
+
+/// The blue value of the color of a CausalLink from 0-255.
+@property int blue;
+
+/// Whether the control and vertex points of a CausalLink are known.  Only records created from a CausalLink in the app have them, a Vensim mdl file only stores the handle.
+@property bool hasArc;
+
+/// The x location of the control point of the arc of a CausalLink, in the coordinates of the model view.
+@property float controlX;
+
+/// The y location of the control point of the arc of a CausalLink, in the coordinates of the model view.
+@property float controlY;
+
+/// The x location of the vertex point of the arc of a CausalLink, in the coordinates of the model view.
+@property float vertexX;
+
+/// The y location of the vertex point of the arc of a CausalLink, in the coordinates of the model view.
+@property float vertexY;
+
+-(id)initWithRecord:(RecordScanner*)record loopName:(NSString*)loopName;
+-(bool)hasTimeDelay;
++(NSString*) sanitizeString:(NSString*)str;
+
+@end
@@ -0,0 +1,144 @@
+//
+//  ComponentRecord.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "ComponentRecord.h"
+#import "Constants.h"
+
+@implementation ComponentRecord
+
+/// Enum containing the indicies of the comma separated fields in which the different attributes of a component in a Vensim mdl file are located.
+/// Every component starts with its type and id, the rest of the indicies depend on the type of the component.
+enum IndexLocations
+{
+    TYPE           = 0,
+    ID             = 1,
+    
+    // Variable and Loop attributes.
+    NAME           = 2,
+    XCOORD         = 3,
+    YCOORD         = 4,
+    SYMBOL         = 7,
+    TEXTPOS        = 11,
+    
+    // CausalLink attributes.
+    PARENT         = 2,
+    CHILD          = 3,
+    POLARITY       = 6,
+    LINE_THICKNESS = 7,
+    DELAY          = 9,
+    ARC_COLOR      = 11,
+    HANDLE_XCOORD  = 13,
+    HANDLE_YCOORD  = 14
+};
+
+@synthesize objectType    = _objectType;
+@synthesize idNum         = _idNum;
+@synthesize name          = _name;
+@synthesize xcoord        = _xcoord;
+@synthesize ycoord        = _ycoord;
+@synthesize symbol        = _symbol;
+@synthesize textPosition  = _textPosition;
+@synthesize parentID      = _parentID;
+@synthesize childID       = _childID;
+@synthesize polarity      = _polarity;
+@synthesize lineThickness = _lineThickness;
+@synthesize delay         = _delay;
+@synthesize hasColor      = _hasColor;
+@synthesize red           = _red;
+@synthesize green         = _green;
+@synthesize blue          = _blue;
+@synthesize hasArc        = _hasArc;
+@synthesize controlX      = _controlX;
+@synthesize controlY      = _controlY;
+@synthesize vertexX       = _vertexX;
+@synthesize vertexY       = _vertexY;
+
+/// Initializes the ComponentRecord from a line of the sketch information of a Vensim mdl file.
+/// The fields are read in the order they appear in the line so the scanner only makes a single pass over it.
+/// @param record a scanner positioned over the line containing all of the data for the component.
+/// @param loopName the name of a Loop.  Unlike Variables, Loop names are located on the line following the rest of the loop attributes.  Ignored for other components.
+/// @return a pointer to the newly created ComponentRecord.
+-(id)initWithRecord:(RecordScanner*)record loopName:(NSString*)loopName
+{
+    self = [super init];
+    if(self)
+    {
+        self.objectType = [record intAtField:TYPE];
+        self.idNum      = [record intAtField:ID];
+        self.name       = @"";
+        
+        switch(self.objectType)
+        {
+            case VARIABLE:
+                self.name         = [ComponentRecord sanitizeString:[record stringAtField:NAME]];
+                self.xcoord       = [record intAtField:XCOORD];
+                self.ycoord       = [record intAtField:YCOORD];
+                self.symbol       = [record intAtField:SYMBOL];
+                self.textPosition = [record intAtField:TEXTPOS];
+                break;
+                
+            case LOOP:
+                self.name         = [ComponentRecord sanitizeString:loopName];
+                self.xcoord       = [record intAtField:XCOORD];
+                self.ycoord       = [record intAtField:YCOORD];
+                self.symbol       = [record intAtField:SYMBOL];
+                self.textPosition = [record intAtField:TEXTPOS];
+                break;
+                
+            case CAUSAL_LINK:
+            {
+                self.parentID      = [record intAtField:PARENT];
+                self.childID       = [record intAtField:CHILD];
+                self.polarity      = [record intAtField:POLARITY];
+                self.lineThickness = [record intAtField:LINE_THICKNESS];
+                self.delay         = [record intAtField:DELAY];
+                
+                // The arc color will be in the format R-G-B, the default ouptut from vensim is -1--1--1.
+                int red, green, blue;
+                self.hasColor = [record colorAtField:ARC_COLOR red:&red green:&green blue:&blue];
+                self.red      = red;
+                self.green    = green;
+                self.blue     = blue;
+                
+                // Turns out vensim stores the handles location not the center point.
+                // The X coord string will be in a format like: 1|(### and the Y coord string will be in a format like: ###)|
+                self.xcoord = [record handleXAtField:HANDLE_XCOORD];
+                self.ycoord = [record handleYAtField:HANDLE_YCOORD];
+                break;
+            }
+                
+            default:
+                // Other sketch objects are not used by the application.
+                break;
+        }
+    }
+    return self;
+}
+
+/// Determines whether the delay value of a CausalLink represents a time delay.
+/// There are four different situations where time delay can exist.
+/// @return true if the causal link has a time delay.
+-(bool)hasTimeDelay
+{
+    return self.delay == TIME_DELAY1 || self.delay == TIME_DELAY2 || self.delay == TIME_DELAY3 || self.delay == TIME_DELAY4;
+}
+
+/// Used to sanitize strings that may contain extraneous escape characters.
+/// Kept here rather than in Component so that it is available without UIKit.
+/// @param str the string that needs to be returned.
+/// @return a string that does not contain any extra backslashes or double-quotes.
++(NSString*) sanitizeString:(NSString*)str
+{
+    NSString* tempString = str;
+    tempString = [tempString stringByReplacingOccurrencesOfString:@"\\" withString:@""];
+    tempString = [tempString stringByReplacingOccurrencesOfString:@"\"\"" withString:@"\""];
+    
+    return tempString;
+}
+
+@end
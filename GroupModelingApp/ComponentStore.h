@@ -0,0 +1,36 @@
+//
+//  ComponentStore.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "Component.h"
+
+/// An ordered collection of components keyed by id.
+/// Adding, removing, and looking up a component by id are all constant time, and fast enumeration visits the components in the order they were added.
+/// A removed component leaves a placeholder in its slot so the slots of the others do not move.  The placeholders are dropped once they outnumber the components, which keeps removal amortized constant time.
+@interface ComponentStore : NSObject <NSFastEnumeration>
+
+/// The components in the order they were added.  Removed components are replaced by NSNull.
+@property NSMutableArray* slots;
+
+/// The slot of every component keyed by id.
+@property NSMutableDictionary* indexes;
+
+/// The number of components in the store.
+@property NSUInteger count;
+
+/// Changed every time a component is added or removed, so enumerating the store while it is modified raises an exception.
+@property unsigned long mutations;
+
+-(id)init;
+-(void) addComponent:(Component*)compo;
+-(void) removeComponent:(Component*)compo;
+-(Component*) componentWithID:(int)idNum;
+-(bool) containsComponent:(Component*)compo;
+-(void) removeAllComponents;
+
+@end
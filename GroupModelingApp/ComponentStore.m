@@ -0,0 +1,141 @@
+//
+//  ComponentStore.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "ComponentStore.h"
+#import "Constants.h"
+
+@implementation ComponentStore
+
+@synthesize slots     = _slots;
+@synthesize indexes   = _indexes;
+@synthesize count     = _count;
+@synthesize mutations = _mutations;
+
+/// Initializes an empty ComponentStore.
+/// @return a pointer to the newly created ComponentStore.
+-(id)init
+{
+    self = [super init];
+    if(self)
+    {
+        self.slots     = [[NSMutableArray alloc] init];
+        self.indexes   = [[NSMutableDictionary alloc] init];
+        self.count     = 0;
+        self.mutations = 0;
+    }
+    return self;
+}
+
+/// Adds a component after every other component.  A component with the same id as one already in the store replaces it in its slot.
+/// @param compo the component to add.
+-(void) addComponent:(Component*)compo
+{
+    NSNumber* key   = [NSNumber numberWithInt:compo.idNum];
+    NSNumber* index = [self.indexes objectForKey:key];
+    if(index)
+    {
+        [self.slots replaceObjectAtIndex:[index unsignedIntegerValue] withObject:compo];
+    }
+    else
+    {
+        [self.indexes setObject:[NSNumber numberWithUnsignedInteger:self.slots.count] forKey:key];
+        [self.slots addObject:compo];
+        self.count++;
+    }
+    self.mutations++;
+}
+
+/// Removes a component, leaving a placeholder in its slot.
+/// @param compo the component to remove.  Nothing happens if it is not in the store.
+-(void) removeComponent:(Component*)compo
+{
+    NSNumber* key   = [NSNumber numberWithInt:compo.idNum];
+    NSNumber* index = [self.indexes objectForKey:key];
+    if(!index || [self.slots objectAtIndex:[index unsignedIntegerValue]] != compo)
+    {
+        return;
+    }
+    
+    [self.slots replaceObjectAtIndex:[index unsignedIntegerValue] withObject:[NSNull null]];
+    [self.indexes removeObjectForKey:key];
+    self.count--;
+    self.mutations++;
+    
+    if(self.slots.count - self.count > MAX(self.count, COMPONENT_STORE_MIN_COMPACT))
+    {
+        [self compact];
+    }
+}
+
+/// Drops the placeholders of removed components and renumbers the slots of the rest, keeping their order.
+-(void) compact
+{
+    NSMutableArray* slots = [[NSMutableArray alloc] initWithCapacity:self.count];
+    NSNull* placeholder = [NSNull null];
+    for(id compo in self.slots)
+    {
+        if(compo != placeholder)
+        {
+            [self.indexes setObject:[NSNumber numberWithUnsignedInteger:slots.count] forKey:[NSNumber numberWithInt:[compo idNum]]];
+            [slots addObject:compo];
+        }
+    }
+    self.slots = slots;
+}
+
+/// Looks up a component by id.
+/// @param idNum the id of the component.
+/// @return the component with the id, nil if it is not in the store.
+-(Component*) componentWithID:(int)idNum
+{
+    NSNumber* index = [self.indexes objectForKey:[NSNumber numberWithInt:idNum]];
+    return (index) ? [self.slots objectAtIndex:[index unsignedIntegerValue]] : nil;
+}
+
+/// Determines whether a component is in the store.
+/// @param compo the component.
+/// @return true if the component is in the store.
+-(bool) containsComponent:(Component*)compo
+{
+    return [self componentWithID:compo.idNum] == compo;
+}
+
+/// Removes every component.
+-(void) removeAllComponents
+{
+    [self.slots removeAllObjects];
+    [self.indexes removeAllObjects];
+    self.count = 0;
+    self.mutations++;
+}
+
+/// Enumerates the components in the order they were added, skipping the placeholders of removed components.
+/// The position in the slots is kept in state->state between calls.
+-(NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state objects:(__unsafe_unretained id [])buffer count:(NSUInteger)len
+{
+    NSUInteger slot     = state->state;
+    NSUInteger returned = 0;
+    NSUInteger total    = self.slots.count;
+    NSNull* placeholder = [NSNull null];
+    
+    while(slot < total && returned < len)
+    {
+        id compo = [self.slots objectAtIndex:slot++];
+        if(compo != placeholder)
+        {
+            buffer[returned++] = compo;
+        }
+    }
+    
+    state->state        = slot;
+    state->itemsPtr     = buffer;
+    state->mutationsPtr = &_mutations;
+    return returned;
+}
+
+@end
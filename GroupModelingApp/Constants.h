@@ -8,7 +8,10 @@
 
 #ifndef GroupModelingApp_Constants_h
 #define GroupModelingApp_Constants_h
+// Only needed by the UIKit side of the app.  Guarded so the Foundation only parsing classes can share these constants.
+#ifdef __APPLE__
 #import "AvailabilityInternal.h"
+#endif
 
 //===============================================================================================================================
 // Constants related to the event logger.
@@ -30,6 +33,20 @@
 #define LINE_TYPE                   @"Line: %@"                             // Used to print out the line thickness of a causal link.
 #define TIME_DELAY_TYPE             @"Time Delay: %@"                       // Used to print out the time delay of the causal link.
 #define COLOR_TYPE                  @"Color: %@"                            // Used to print out the color of the causal link.
+#define NUMBER_RESTORED             @"Number of components restored: %d | " // Used to describe how many components were restored from the edit journal.
+#define IMPORT_COUNTS               @"Variables: %d Links: %d Loops: %d | " // Used to describe the number of components in an import summary.
+#define IMPORT_TABLE_ROW            @"%d,%d,%d,%d,%d;"                      // Used for each component in an import summary as id,type,x,y,flags.
+#define TRANSACTION_COUNTS          @"%@ | Added: %d Changed: %d Removed: %d | " // Used to describe a transaction by its action and the number of components it touched.
+#define TRANSACTION_IDS             @"%@: %@ | "                            // Used to list the ids of the components a transaction touched as ranges, ex. Removed: 3-7,12.
+#define UNDO_DETAILS                @"Event: %d | Components: %d | "        // Used to describe an undone or redone step by the event that made it and the number of components it touched.
+#define LOOPS_FOUND_DETAILS         @"Loops: %d Reinforcing: %d Balancing: %d Truncated: %d | " // Used to describe the feedback loops found in a model.
+
+// Constants for the import summary flags.  Set bits describe the attributes of a component.
+#define IMPORT_FLAG_SYMBOL          1                                       // The Variable is boxed, the Loop is clockwise, or the CausalLink has + polarity.
+#define IMPORT_FLAG_BOLD            2                                       // The CausalLink is bold.
+#define IMPORT_FLAG_TIME_DELAY      4                                       // The CausalLink has a time delay.
+#define IMPORT_FLAG_COLOR           8                                       // The CausalLink has a color other than the default.
+#define DEFAULT_IMPORT_LOG_MODE     IMPORT_LOG_VERBOSE                      // Verbose so that the study logs keep the same format.
 
 // Header Labels for the log
 #define EVENT_ID                    @"Event ID"
@@ -201,7 +218,30 @@ enum EventLoggingGenericMessages
     CASUAL_LINK_CANCELLED,
     BEGIN_VAR_MOVE,
     VAR_MOVE,
-    END_VAR_MOVE
+    END_VAR_MOVE,
+    
+    // Messages added after the initial study. Appended so the ids of the messages above do not change.
+    
+    // Messages for ModelSectionViewController
+    FILE_LOAD_FAILED,
+    
+    // Messages for Model
+    IMPORTED_MODEL_SUMMARY,
+    RESTORED_MODEL,
+    TRANSACTION_COMMITTED,
+    UNDO_STEP,
+    REDO_STEP,
+    LOOPS_DISCOVERED,
+    
+    // Messages for FileIO
+    EXPORT_FAILED
+};
+
+/// How the components read in from a file are recorded in the event log.
+enum ImportLogMode
+{
+    IMPORT_LOG_VERBOSE = 0, // One event with a formatted description for every imported Variable, CausalLink, and Loop.  Used for the research study.
+    IMPORT_LOG_SUMMARY = 1  // A single event with the number of each component and a compact table of every component.
 };
 
 //===============================================================================================================================
@@ -291,9 +331,19 @@ enum LineThickness
 #define ENDING_HASH                @"EndingHash"                   // The name of the column that contains the ending hash of the file.
 #define EVENT_LOG                  @"EventLog"                     // The name of the column that contains the event log file.
 #define MODEL_FILE                 @"ModelFile"                    // The name of the column that contains the model file.
+#define MODEL_DELTA                @"ModelDelta"                   // The name of the column that contains the changes to the model since the previous record, used instead of ModelFile.
+#define MODEL_DELTA_FILE           @"model.delta"                  // File name of the uploaded changes to the model.
 #define GID                        @"gid"                          // The name of the column that contains the unique file id for user file combination.
 #define EMPTY_MODEL_HASH           @"ltEdSngfjGsLG7ttO+fLWgv6YN8=" // The hash value of an empty model.
 
+// The markers of a delta between two exported models.  See ModelVersion.
+#define DELTA_HEADER               @"{GMA delta 1}"                // The first line of every delta.
+#define DELTA_PREFIX               '!'                             // Replaces every line before the records.
+#define DELTA_REMOVE               '-'                             // Removes the record of a component.
+#define DELTA_CHANGE               '~'                             // Replaces the record of a component.
+#define DELTA_ADD                  '+'                             // Adds a record after all other records.
+#define DELTA_TRAILER              '='                             // Replaces every line after the records.
+
 // Strings that specifiy where in the Vensim mdl file certain aspects of the model are located.
 #define  COMPONENT_PREFIX          @"\\\\\\"   // The beginning of the line in the Vensim file that starts the component definitions.
 #define  DEFAULT_PARAMS_PREFIX     @"$"        // The beginning character that starts the default params line.
@@ -408,6 +458,77 @@ enum ModelSectionViewAlerts
 #define MDL_EXTENSION           @".mdl"                     // Accepted file extension.
 #define TXT_EXTENSION           @".txt"                     // Accepted file extension.
 #define LOG_QUEUE               "log_queue"                 // The name of the asynch queue used to push logs to Parse.
+#define LOAD_QUEUE              "load_queue"                // The name of the asynch queue used to download and parse model files.
+#define LOADING_TITLE           @"Opening %@ (%d%%)"        // Title displayed while a model file is being opened.
+#define COMPONENT_STORE_MIN_COMPACT 64                   // A ComponentStore keeps at least this many placeholders of removed components before compacting.
+#define CACHE_QUEUE             "cache_queue"               // The name of the queue used to read and write the parsed model cache.
+#define JOURNAL_QUEUE           "journal_queue"             // The name of the queue used to write the edit journal.
+#define EXPORT_QUEUE            "export_queue"              // The name of the queue used to write exported model files.
+#define EXPORT_BUFFER_SIZE      (64 * 1024)                 // Number of bytes collected before an exported model is written to disk.
+#define RECORD_BUILDER_CAPACITY 256                         // Starting number of bytes of a RecordBuilder.  Grows to fit longer lines.
+
+// Constants for the parsed model cache.
+#define MODEL_CACHE_DIRECTORY   @"ModelCache"               // Folder within the caches directory that holds the snapshots.
+#define MODEL_CACHE_EXTENSION   @"snapshot"                 // File extension of a snapshot.
+#define MODEL_CACHE_MAX_BYTES   (32 * 1024 * 1024)          // Snapshots are evicted least recently used first once they take up more than this.
+
+// Constants for the binary model format.
+#define MODEL_ARCHIVE_MAGIC     0x42414D47                  // "GMAB", the first four bytes of every archive.
+#define MODEL_ARCHIVE_VERSION   1                           // Increase whenever ArchiveHeader, ArchiveRecord, or the meaning of their fields change.
+
+// Constants for the edit journal.
+#define MODEL_JOURNAL_DIRECTORY     @"Journal"              // Folder within the application support directory that holds the journal.
+#define MODEL_JOURNAL_SNAPSHOT      @"model.snapshot"       // The model as it was when it was opened or last compacted.
+#define MODEL_JOURNAL_LOG           @"model.journal"        // Every edit since the snapshot.
+#define MODEL_JOURNAL_FLUSH_DELAY   0.5                     // Seconds edits are collected for before they are written as a batch.
+#define MODEL_JOURNAL_COMPACT_BYTES (1024 * 1024)           // The log is folded into a new snapshot once it is larger than this.
+
+// Constants for the undo history.
+#define UNDO_BYTE_BUDGET            (256 * 1024)            // The oldest steps are dropped once the undo and redo steps take up more than this.
+#define UNDO_TITLE                  @"Undo"                 // Title of the button that undoes the last edit.
+#define REDO_TITLE                  @"Redo"                 // Title of the button that redoes the last undone edit.
+
+// Constants for finding the feedback loops of a model.
+#define LOOP_QUEUE                  "loop_queue"            // The name of the queue used to search for feedback loops.
+#define LOOP_FINDER_MAX_LOOPS       1000                    // The search stops once this many loops have been found.
+#define LOOP_FINDER_MAX_LENGTH      12                      // Only loops with at most this many links are found.
+#define LOOP_FINDER_BATCH_SIZE      64                      // Number of loops handed out at a time while the search runs.
+#define REINFORCING_LABEL           @"R"                    // Label of a reinforcing loop.
+#define BALANCING_LABEL             @"B"                    // Label of a balancing loop.
+
+// Constants for the import and export benchmark.
+#define BENCHMARK_FILE_ARG           @"benchmarkFile"        // Launch argument with the path of the mdl file to benchmark.
+#define BENCHMARK_ITERATIONS_ARG     @"benchmarkIterations"  // Launch argument with the number of times to run each phase.
+#define BENCHMARK_DEFAULT_ITERATIONS 5                       // Number of times each phase is run if no count is given.
+#define BENCHMARK_RESULTS_FILE       @"benchmark.json"       // File in the documents directory the results are written to.
+#define BENCHMARK_OUTPUT_MDL         @"benchmark.mdl"        // Temporary file the export phases write to.
+#define BENCHMARK_OUTPUT_ARCHIVE     @"benchmark.gma"        // Temporary file the archive phases write to.
+
+// Keys of the benchmark results.
+#define BENCHMARK_FILE               @"file"
+#define BENCHMARK_BYTES              @"bytes"
+#define BENCHMARK_VARIABLES          @"variables"
+#define BENCHMARK_LINKS              @"links"
+#define BENCHMARK_LOOPS              @"loops"
+#define BENCHMARK_ITERATIONS         @"iterations"
+#define BENCHMARK_CORES              @"cores"
+#define BENCHMARK_SYSTEM             @"system_version"
+#define BENCHMARK_BUILD              @"build"
+#define BENCHMARK_PHASES             @"phases"
+#define BENCHMARK_MIN                @"min_ms"
+#define BENCHMARK_MEDIAN             @"median_ms"
+#define BENCHMARK_MEAN               @"mean_ms"
+#define BENCHMARK_MAX                @"max_ms"
+
+// Phases of the benchmark.
+#define BENCHMARK_PARSE              @"parse"                // Tokenizing the file into a ModelGraph.
+#define BENCHMARK_CONSTRUCT          @"construct_components" // Creating every component and its view.
+#define BENCHMARK_CONNECT            @"connect_causal_links" // Pointing the causal links to their parent and child.
+#define BENCHMARK_SNAPSHOT           @"snapshot"             // Rendering the variable maps and records of every component into a ModelSnapshot.
+#define BENCHMARK_EXPORT             @"export"               // Streaming the snapshot to a mdl file with an ExportStream, which hashes it inline.
+#define BENCHMARK_ARCHIVE_WRITE      @"write_archive"        // Writing the model as a ModelArchive.
+#define BENCHMARK_ARCHIVE_READ       @"read_archive"         // Mapping the archive and reading it into a ModelGraph, the counterpart of parse.
+#define BENCHMARK_FIND_LOOPS         @"find_loops"           // Copying the links into a LoopFinder and finding every feedback loop.
 
 // Alert Messages.
 #define NEW_MODEL_MSG           @"Are you sure you would like to create a new model? All unsaved changes will be lost."
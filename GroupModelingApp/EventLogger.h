@@ -18,6 +18,9 @@
 /// An array containing the mapping of event ids to their description.
 @property NSMutableDictionary* eventsKey;
 
+/// How components read in from a file are recorded.  Either IMPORT_LOG_VERBOSE or IMPORT_LOG_SUMMARY.
+@property int importLogMode;
+
 +(EventLogger*)sharedEventLogger;
 -(void)addEvent:(Event*)newEvent;
 -(NSMutableArray*)createEventsOutput;
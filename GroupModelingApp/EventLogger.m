@@ -13,6 +13,7 @@
 
 @synthesize events    = _events;
 @synthesize eventsKey = _eventsKey;
+@synthesize importLogMode = _importLogMode;
 
 /// Forces the EventLogger to be a singleton class.
 /// @return a pointer to the single instance of the event logger.
@@ -22,6 +23,7 @@
     dispatch_once(&onceToken, ^{
         sharedEventLogger = [[self alloc] init];
         sharedEventLogger.events   = [[NSMutableArray alloc] init];
+        sharedEventLogger.importLogMode = DEFAULT_IMPORT_LOG_MODE;
         [sharedEventLogger populateEventKey];
     });
     return sharedEventLogger;
@@ -198,5 +200,19 @@
     [self.eventsKey setObject:@"User began moving a variable."                          forKey:[NSNumber numberWithInt: BEGIN_VAR_MOVE]];
     [self.eventsKey setObject:@"User is moving a variable."                             forKey:[NSNumber numberWithInt: VAR_MOVE]];
     [self.eventsKey setObject:@"User stopped moving a variable."                        forKey:[NSNumber numberWithInt: END_VAR_MOVE]];
+    
+    // Messages for ModelSectionViewController added after the initial study.
+    [self.eventsKey setObject:@"The selected file could not be downloaded or read."     forKey:[NSNumber numberWithInt: FILE_LOAD_FAILED]];
+    
+    // Messages for Model added after the initial study.
+    [self.eventsKey setObject:@"Imported a model from a file. Table is id,type,x,y,flags" forKey:[NSNumber numberWithInt: IMPORTED_MODEL_SUMMARY]];
+    [self.eventsKey setObject:@"Restored the model from the edit journal after the app was closed." forKey:[NSNumber numberWithInt: RESTORED_MODEL]];
+    [self.eventsKey setObject:@"Edited many components at once. Lists the ids added, changed and removed." forKey:[NSNumber numberWithInt: TRANSACTION_COMMITTED]];
+    [self.eventsKey setObject:@"Undid the last edit. The object id is the one logged for the edit." forKey:[NSNumber numberWithInt: UNDO_STEP]];
+    [self.eventsKey setObject:@"Redid the last undone edit. The object id is the one logged for the edit." forKey:[NSNumber numberWithInt: REDO_STEP]];
+    [self.eventsKey setObject:@"Found the feedback loops of the model after it was opened. Counts the reinforcing and balancing loops." forKey:[NSNumber numberWithInt: LOOPS_DISCOVERED]];
+    
+    // Messages for FileIO added after the initial study.
+    [self.eventsKey setObject:@"The model could not be written to a file, so it was not saved or uploaded." forKey:[NSNumber numberWithInt: EXPORT_FAILED]];
 }
 @end
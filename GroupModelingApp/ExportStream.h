@@ -0,0 +1,41 @@
+//
+//  ExportStream.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/// Writes the lines of an exported Vensim mdl file directly to disk while taking the sha1 hash of everything written.
+/// Lines are separated by a single newline with no newline after the last line.
+/// Output is collected in a fixed size buffer and flushed when it fills, so memory use does not depend on the size of the model.
+@interface ExportStream : NSObject
+
+/// The stream of the file being written.
+@property NSOutputStream* stream;
+
+/// Bytes waiting to be written to the stream.
+@property NSMutableData* buffer;
+
+/// Whether any line has been written yet.  Every line after the first is preceded by a newline.
+@property bool hasWrittenLine;
+
+/// Whether a write to the stream failed.
+@property bool failed;
+
+/// The lines written since beginCapture, joined by newlines.  nil when lines are not being captured.
+@property NSMutableData* capture;
+
+/// Whether a line has been captured yet.  Every captured line after the first is preceded by a newline.
+@property bool hasCapturedLine;
+
+-(id)initWithPath:(NSString*)path;
+-(void)writeLine:(NSString*)line;
+-(void)writeLineBytes:(const void*)bytes length:(NSUInteger)length;
+-(void)beginCapture;
+-(NSData*)endCapture;
+-(NSData*)close;
+
+@end
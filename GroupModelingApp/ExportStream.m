@@ -0,0 +1,152 @@
+//
+//  ExportStream.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <CommonCrypto/CommonDigest.h>
+#import "Constants.h"
+#import "ExportStream.h"
+
+@implementation ExportStream
+{
+    /// The running sha1 hash of every byte written.
+    CC_SHA1_CTX _sha1Context;
+}
+
+@synthesize stream          = _stream;
+@synthesize buffer          = _buffer;
+@synthesize hasWrittenLine  = _hasWrittenLine;
+@synthesize failed          = _failed;
+@synthesize capture         = _capture;
+@synthesize hasCapturedLine = _hasCapturedLine;
+
+/// Initializes the ExportStream and opens the file for writing.  Any existing file at the path is replaced.
+/// @param path the location of the file to write.
+/// @return a pointer to the newly created ExportStream.
+-(id)initWithPath:(NSString*)path
+{
+    self = [super init];
+    if(self)
+    {
+        self.stream         = [NSOutputStream outputStreamToFileAtPath:path append:NO];
+        self.buffer         = [[NSMutableData alloc] initWithCapacity:EXPORT_BUFFER_SIZE];
+        self.hasWrittenLine = NO;
+        self.failed         = NO;
+        CC_SHA1_Init(&_sha1Context);
+        [self.stream open];
+    }
+    return self;
+}
+
+/// Writes a line of the file.
+/// @param line the line to write.  May contain newlines of its own.
+-(void)writeLine:(NSString*)line
+{
+    const char* utf8 = [line UTF8String];
+    [self writeLineBytes:utf8 length:strlen(utf8)];
+}
+
+/// Writes a line of the file that has already been encoded as UTF-8.
+/// @param bytes the bytes of the line.
+/// @param length the number of bytes in the line.
+-(void)writeLineBytes:(const void*)bytes length:(NSUInteger)length
+{
+    if(self.hasWrittenLine)
+    {
+        [self appendBytes:"\n" length:1];
+    }
+    self.hasWrittenLine = YES;
+    [self appendBytes:bytes length:length];
+    
+    if(self.capture)
+    {
+        if(self.hasCapturedLine)
+        {
+            [self.capture appendBytes:"\n" length:1];
+        }
+        self.hasCapturedLine = YES;
+        [self.capture appendBytes:bytes length:length];
+    }
+}
+
+/// Starts keeping a copy of every line written, so part of the file can be kept without reading it back.
+-(void)beginCapture
+{
+    self.capture         = [[NSMutableData alloc] init];
+    self.hasCapturedLine = NO;
+}
+
+/// Stops keeping a copy of the lines written.
+/// @return the lines written since beginCapture, joined by newlines.
+-(NSData*)endCapture
+{
+    NSData* captured = self.capture;
+    self.capture = nil;
+    return captured;
+}
+
+/// Adds bytes to the output and the hash, flushing the buffer to the stream when it is full.
+/// @param bytes the bytes to add.
+/// @param length the number of bytes to add.
+-(void)appendBytes:(const void*)bytes length:(NSUInteger)length
+{
+    CC_SHA1_Update(&_sha1Context, bytes, (CC_LONG)length);
+    
+    if(self.buffer.length + length > EXPORT_BUFFER_SIZE)
+    {
+        [self flush];
+    }
+    // Lines larger than the buffer are written straight through.
+    if(length > EXPORT_BUFFER_SIZE)
+    {
+        [self writeBytes:bytes length:length];
+    }
+    else
+    {
+        [self.buffer appendBytes:bytes length:length];
+    }
+}
+
+/// Writes everything in the buffer to the stream.
+-(void)flush
+{
+    [self writeBytes:self.buffer.bytes length:self.buffer.length];
+    [self.buffer setLength:0];
+}
+
+/// Writes bytes to the stream, which may take more than one write.
+/// @param bytes the bytes to write.
+/// @param length the number of bytes to write.
+-(void)writeBytes:(const void*)bytes length:(NSUInteger)length
+{
+    NSUInteger written = 0;
+    while(written < length && !self.failed)
+    {
+        NSInteger result = [self.stream write:(const uint8_t*)bytes + written maxLength:length - written];
+        if(result <= 0)
+        {
+            self.failed = YES;
+        }
+        else
+        {
+            written += result;
+        }
+    }
+}
+
+/// Flushes any remaining output and closes the file.
+/// @return the sha1 hash of everything written, nil if the file could not be written.
+-(NSData*)close
+{
+    [self flush];
+    [self.stream close];
+    
+    unsigned char hash[CC_SHA1_DIGEST_LENGTH];
+    CC_SHA1_Final(hash, &_sha1Context);
+    return (self.failed) ? nil : [NSData dataWithBytes:hash length:CC_SHA1_DIGEST_LENGTH];
+}
+
+@end
@@ -7,19 +7,32 @@
 //
 
 #import <Foundation/Foundation.h>
+#import "ModelSnapshot.h"
+#import "ModelVersion.h"
 
 /// A class that handles the parsing of mdl files to import into the application.  Also is responsible for exporting the model back into a Vensim file for saving state and for use in Vensim again.
 @interface FileIO : NSObject
 
+/// The structure of the file written by the last export.
+@property ModelVersion* exportedVersion;
+
+/// The snapshot of the model the last export was written from.
+@property ModelSnapshot* exportedSnapshot;
+
+/// The structure of the file in the last record uploaded to Parse.  Later uploads that start from this file only send a delta from it.  Only set on the main thread.
+@property ModelVersion* uploadedVersion;
+
+/// The serial queue the exported files are written on.
+@property dispatch_queue_t exportQueue;
+
 + (FileIO*)sharedFileIO;
--(void) importModel:(NSArray*)lines;
+-(void) importModelData:(NSData*)data;
 -(NSString*) openFile;
--(NSURL*) exportModel;
--(void) exportEventLogging;
--(NSNumber*) getFileID;
+-(void) exportModelWithCompletion:(void (^)(NSURL* url))completion;
+-(ModelVersion*) exportSnapshot:(ModelSnapshot*)snapshot toPath:(NSString*)path;
+-(void) exportEventLoggingForSnapshot:(ModelSnapshot*)snapshot version:(ModelVersion*)exported;
+-(NSNumber*) getFileIDForHash:(NSData*)startingHash;
 -(NSNumber*) getNextAvailableFileID;
--(void) processComponent:(NSString*) string loopName:(NSString*) loopName;
--(void) updateCausalLinkConnections;
 +(NSData*)sha1:(NSData *)data;
 + (NSString*)base64forData:(NSData*)theData;
 
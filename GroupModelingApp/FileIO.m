@@ -12,9 +12,12 @@
 #import <CommonCrypto/CommonDigest.h>
 #import "DefaultParameters.h"
 #import "EventLogger.h"
+#import "ExportStream.h"
 #import "Loop.h"
 #import "FileIO.h"
 #import "Model.h"
+#import "ModelParser.h"
+#import "ModelVersion.h"
 #import "Reachability.h"
 #import "Variable.h"
 
@@ -23,6 +26,11 @@ NSString* MODEL_EXPORT_FILE = @"model.mdl";
 
 @implementation FileIO
 
+@synthesize exportedVersion  = _exportedVersion;
+@synthesize uploadedVersion  = _uploadedVersion;
+@synthesize exportedSnapshot = _exportedSnapshot;
+@synthesize exportQueue      = _exportQueue;
+
 /// Forces the Model to be a singleton class.
 /// @return a pointer to the single instance of the model.
 + (FileIO*)sharedFileIO {
@@ -30,6 +38,7 @@ NSString* MODEL_EXPORT_FILE = @"model.mdl";
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
         sharedFileIO = [[self alloc] init];
+        sharedFileIO.exportQueue = dispatch_queue_create(EXPORT_QUEUE, DISPATCH_QUEUE_SERIAL);
         // iOS 6.0 or later
         if([[[UIDevice currentDevice] systemVersion] floatValue] >= 6.0)
         {
@@ -45,65 +54,13 @@ NSString* MODEL_EXPORT_FILE = @"model.mdl";
 }
 
 /// Opens a Vensim mdl file and parses through it to populate the model.
+/// The file is first parsed into a ModelGraph, then the Model creates the components and their views from it in a single batch.
 /// Will update the Model object with its simulation control parameters, default model parameters, and all components including any Variable, CausalLink, and Loop.
--(void) importModel:(NSArray*)lines
+/// @param data the raw contents of the mdl file.
+-(void) importModelData:(NSData*)data
 {
-    //NSString* content = [self openFile];
-    
-    // Split up the textfile by line
-    //NSArray* lines = [content componentsSeparatedByString:@"\n"];
-    
-    bool readComponents = false; // Flag determining when to read components from the file
-    bool readControls   = false; // Flag determining when to read simulation control parameters from the file
-    
-    for(NSString* string in lines)
-    {
-        // Determine when to read controls and when to  read components
-        if(string.length > COMPONENT_PREFIX.length && [string hasPrefix:(NSString*)COMPONENT_PREFIX])
-        {
-            readControls   = false;
-            readComponents = true;
-        }
-        
-        // Read in default parameters
-        if(string.length >= DEFAULT_PARAMS_PREFIX.length && [string hasPrefix:(NSString*)DEFAULT_PARAMS_PREFIX])
-        {
-            [[[Model sharedModel] defaultParams] setParams:string];
-        }
-        
-        // Read in the simulation control parameters
-        if([string hasPrefix:(NSString*)SIM_CONTROL_PARAMS_PREFIX] || readControls)
-        {
-            readControls = true;
-            [[[Model sharedModel] controlParams] addParameter:string];
-        }
-        
-        // Read in the components
-        if(readComponents && ![string hasPrefix:(NSString*)END_OF_COMPONENTS])
-        {
-            // Get the largest component id, if it is there.  The id will only exist if the the file being loaded had been saved previously from the app.
-            // Otherwise if the file was originally created from Vensim, the last object will have the highest id and the largestIDNum will be set automatically.
-            // This string will actually exist after all components.
-            if([string hasPrefix:(NSString*)LARGEST_COMPONENT_ID])
-            {
-                int idNum = [[[string componentsSeparatedByString:@"-"]objectAtIndex:1] integerValue];
-                [Component setLargestIDNum:idNum];
-            }
-            else // Read the component.
-            {
-                /// @todo The name of the loop being on the next line kind of a pain
-                NSString* loopName = ([lines indexOfObject:string]+1 > lines.count-1) ? @"" : lines[[lines indexOfObject:string]+1];
-                [self processComponent:string loopName:loopName];
-            }
-        }
-        else // stop reading components data when there are no more. Vensim sometimes outputs more information at the end of the file.
-        {
-            readComponents = false;
-        }
-    }
-
-    // Now that the file is completely read in, we can point the causal links to their parent and child objects.
-    [self updateCausalLinkConnections];
+    ModelGraph* graph = [[[ModelParser alloc] init] parseData:data];
+    [[Model sharedModel] loadGraph:graph];
 }
 
 /// Will open the selected Vensim file to import and use.
@@ -127,82 +84,133 @@ NSString* MODEL_EXPORT_FILE = @"model.mdl";
 
 }
 
-/// Will export the model and write it to a file output.mdl.
-/// @return the url location of the file.
--(NSURL*) exportModel
+/// Will export the model and write it to a file output.mdl without blocking the main thread.
+/// A snapshot of the model is taken on the main thread and written on the export queue, so the user can keep editing while the file is written and hashed.
+/// Once the file is written, the ending hash of the model, exportedVersion and exportedSnapshot are set and the completion block is called on the main thread.
+/// If the file could not be written, none of them are set so the partial file is never uploaded.
+/// @param completion called with the url location of the file, nil if the file could not be written.
+-(void) exportModelWithCompletion:(void (^)(NSURL* url))completion
+{
+    Model* model = [Model sharedModel];
+    ModelSnapshot* snapshot = [model snapshot];
+    
+    // Get the file location to save the file.
+    NSArray *dirPaths = NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES);
+    NSString* docsDir = [dirPaths objectAtIndex:0];
+    docsDir =  [docsDir stringByAppendingPathComponent:MODEL_EXPORT_FILE];
+    
+    dispatch_async(self.exportQueue, ^{
+        ModelVersion* version = [self exportSnapshot:snapshot toPath:docsDir];
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            // The stream has no hash when a write failed.
+            if(!version.fileHash)
+            {
+                [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID:EXPORT_FAILED andDetails:MODEL_EXPORT_FILE]];
+                completion(nil);
+                return;
+            }
+            
+            // Set the ending hash.
+            [model setEndingHash:version.fileHash];
+            self.exportedVersion  = version;
+            self.exportedSnapshot = snapshot;
+            
+            // Return the url to the file so that Dropbox can use it.
+            completion([[NSURL alloc]initFileURLWithPath:docsDir]);
+        });
+    });
+}
+
+/// Writes a snapshot of a model as a mdl file.  Does not touch the live model, so it can be called on any thread.
+/// Each line is streamed to the file and hashed along the way, so the file is written in a single pass and never read back.
+/// @param snapshot the snapshot to write.
+/// @param path the location of the file.
+/// @return the structure of the file, so the upload can send only what changed.
+-(ModelVersion*) exportSnapshot:(ModelSnapshot*)snapshot toPath:(NSString*)path
 {
-    NSMutableArray* file = [[NSMutableArray alloc]init];
+    ExportStream* file = [[ExportStream alloc] initWithPath:path];
+    
+    // Keep everything before the records as a single block of the version.
+    ModelVersion* version = [[ModelVersion alloc] init];
+    [file beginCapture];
     
     // Add the encoding schem
-    [file addObject:ENCODING]; // The encoding scheme
+    [file writeLine:ENCODING]; // The encoding scheme
     
     // Add the variable maps.
-    [file addObjectsFromArray:[[Model sharedModel] createVariableMap]];
+    for(NSData* varMap in snapshot.varMaps)
+    {
+        [file writeLineBytes:varMap.bytes length:varMap.length];
+        [file writeLine:TILDE];
+        [file writeLine:TILDE_BAR];
+    }
 
     // Add the control params.
-    if([Model sharedModel].controlParams.params.count > 0)
+    if(snapshot.controlParams.count > 0)
     {
-        [file addObjectsFromArray:[Model sharedModel].controlParams.params];
+        for(NSString* line in snapshot.controlParams)
+        {
+            [file writeLine:line];
+        }
     }
     else
     {
          // If no control params have been created (ie model created on the app itself) add default control params.
-        [file addObject:CONTROL_PARAMS];
+        [file writeLine:CONTROL_PARAMS];
     }
     
     // Add standard lines.
-    [file addObject:SKETCH_INFO];
-    [file addObject:V300];
-    [file addObject:VIEW];
+    [file writeLine:SKETCH_INFO];
+    [file writeLine:V300];
+    [file writeLine:VIEW];
     
     // Add the default params.
-    NSString* defaultParams = [Model sharedModel].defaultParams.params;
-    if([defaultParams isEqualToString:@""])
+    if([snapshot.defaultParams isEqualToString:@""])
     {
         // If no params have been created (ie model created on the app itself) add default params.
-        [file addObject:DEFAULT_PARAMS];
+        [file writeLine:DEFAULT_PARAMS];
     }
     else
     {
-        [file addObject:defaultParams];
+        [file writeLine:snapshot.defaultParams];
     }
+    version.prefix = [file endCapture];
     
-    // Add all of the components in the model.
-    [file addObjectsFromArray:[[Model sharedModel] createComponentsExport]];
+    // Add all of the components in the model, in the order they were added so the records keep the order of the original file.
+    for(NSUInteger i = 0; i < snapshot.records.count; ++i)
+    {
+        NSData* record = [snapshot.records objectAtIndex:i];
+        [file writeLineBytes:record.bytes length:record.length];
+        [version addRecord:record forID:[[snapshot.ids objectAtIndex:i] intValue]];
+    }
     
     /// Add the current max ID, used for tracking events. Stored as -##.
-    [file addObject:[NSString stringWithFormat:@"-%d", [Component getLargestIDNum]]];
+    [file beginCapture];
+    RecordBuilder* builder = [[RecordBuilder alloc] init];
+    [builder appendLiteral:"-"];
+    [builder appendInt:snapshot.largestIDNum];
+    [file writeLineBytes:[builder bytes] length:builder.length];
 
-    // Get the file location to save the file.
-    NSArray *dirPaths = NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES);
-    NSString* docsDir = [dirPaths objectAtIndex:0];
-    docsDir =  [docsDir stringByAppendingPathComponent:MODEL_EXPORT_FILE];
-    
-    // Split up the file by the end of line character and write it to the file.
-    NSError* error;
-    [[file componentsJoinedByString:@"\n"] writeToFile:docsDir atomically:NO encoding:NSUTF8StringEncoding error:&error];
-    
-    // Set the ending hash.
-    NSData* hash = [FileIO sha1:[[NSFileManager defaultManager]contentsAtPath:docsDir]];
-
-    // Ensure that the model attempting to be save is the empty model. If it is, append a random number
+    // If the model being saved is the empty model, append a random number
     // so there isn't conflicts in the Parse database for tracking user model sessions.
     /// @todo probably want a more robust way of handling users saving blank files first.
-    if([[FileIO base64forData:hash] isEqualToString: EMPTY_MODEL_HASH])
+    if(snapshot.isEmpty)
     {
-        [file addObject:[NSString stringWithFormat:@"%d", arc4random() % 10000000]];
-        [[file componentsJoinedByString:@"\n"] writeToFile:docsDir atomically:NO encoding:NSUTF8StringEncoding error:&error];
-        hash = [FileIO sha1:[[NSFileManager defaultManager]contentsAtPath:docsDir]];
+        [file writeLine:[NSString stringWithFormat:@"%d", arc4random() % 10000000]];
     }
     
-    [[Model sharedModel] setEndingHash:hash];
-
-    // Return the url to the file so that Dropbox can use it.
-    return [[NSURL alloc]initFileURLWithPath:docsDir];
+    version.trailer  = [file endCapture];
+    version.fileHash = [file close];
+    return version;
 }
 
 /// Will export the model event logging data and write it to a file eventLogging.txt.
--(void) exportEventLogging
+/// Only reads the snapshot and version of the file that was exported, never the live model, so it can run on a background queue while the model is edited.
+/// Once the record is saved, the starting hash of the model is moved to the uploaded file on the main thread.
+/// @param snapshot the snapshot of the model that was exported.
+/// @param exported the structure of the file that was exported from the snapshot.
+-(void) exportEventLoggingForSnapshot:(ModelSnapshot*)snapshot version:(ModelVersion*)exported
 {
     // Get the number of events in the log. Will be used later to only remove the events that existed at this point.
     int numEvents = [EventLogger sharedEventLogger].events.count;
@@ -213,12 +221,21 @@ NSString* MODEL_EXPORT_FILE = @"model.mdl";
     PFFile *log = [PFFile fileWithName:EVENTS_EXPORT_FILE data:data];
     
     // Get the mdl file to save as well.
-    NSArray *dirPaths = NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES);
-    NSString* docsDir = [dirPaths objectAtIndex:0];
-    docsDir =  [docsDir stringByAppendingPathComponent:MODEL_EXPORT_FILE];
+    data = [exported fileData];
     
-    data =[NSData dataWithContentsOfURL:[[NSURL alloc]initFileURLWithPath:docsDir]];
-    PFFile* model = [PFFile fileWithName:MODEL_EXPORT_FILE data:data];
+    // When the last record uploaded holds the file this model started from, only the components that changed since then are sent.
+    // The full file is still sent if the delta would not be smaller.
+    ModelVersion* uploaded = self.uploadedVersion;
+    NSData* delta = nil;
+    if(uploaded && [uploaded.fileHash isEqualToData:snapshot.startingHash])
+    {
+        delta = [exported deltaFromVersion:uploaded];
+        if(delta.length >= data.length)
+        {
+            delta = nil;
+        }
+    }
+    PFFile* model = (delta) ? [PFFile fileWithName:MODEL_DELTA_FILE data:delta] : [PFFile fileWithName:MODEL_EXPORT_FILE data:data];
     
     // Get the current user.
     [PFUser enableAutomaticUser];
@@ -229,12 +246,12 @@ NSString* MODEL_EXPORT_FILE = @"model.mdl";
     {
         PFObject *eventLog = [PFObject objectWithClassName:CLASS_NAME];
         [eventLog setObject:[PFUser currentUser].username    forKey:USER_ID];
-        [eventLog setObject:[Model sharedModel].startingHash forKey:STARTING_HASH];
-        [eventLog setObject:[Model sharedModel].endingHash   forKey:ENDING_HASH];
+        [eventLog setObject:snapshot.startingHash            forKey:STARTING_HASH];
+        [eventLog setObject:exported.fileHash                forKey:ENDING_HASH];
         [eventLog setObject:log                              forKey:EVENT_LOG];
-        [eventLog setObject:model                            forKey:MODEL_FILE];
+        [eventLog setObject:model                            forKey:(delta) ? MODEL_DELTA : MODEL_FILE];
         
-        NSNumber* fileID = [self getFileID];
+        NSNumber* fileID = [self getFileIDForHash:snapshot.startingHash];
         if(fileID.integerValue > 0)
         {
             [eventLog setObject:fileID                           forKey:GID];
@@ -247,12 +264,17 @@ NSString* MODEL_EXPORT_FILE = @"model.mdl";
                         
                 // Set the starting hash to the end hash. Now the user can continue working.
                 // The end hash will be recomputed and set again prior to the next record being saved.
-                [Model sharedModel].startingHash = [[Model sharedModel] endingHash];
+                // The server now holds this file, so the next upload can be a delta from it.
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    [Model sharedModel].startingHash = exported.fileHash;
+                    [[Model sharedModel].journal startingHashChanged:exported.fileHash];
+                    self.uploadedVersion = exported;
+                });
             }
             else
             {
                 [[EventLogger sharedEventLogger]addEvent: [[Event alloc] initWithDescID:UPLOAD_TO_PARSE_FAILED
-                                                                            andDetails:[[NSString alloc]initWithFormat:NO_PARSE_CONNECTION, [FileIO base64forData:[Model sharedModel].endingHash]]]];
+                                                                            andDetails:[[NSString alloc]initWithFormat:NO_PARSE_CONNECTION, [FileIO base64forData:exported.fileHash]]]];
             }
         }
         else
@@ -271,14 +293,15 @@ NSString* MODEL_EXPORT_FILE = @"model.mdl";
 
 /// Get the parent file global idenitifer (gid) so we can keep track of when a specific user modifies the same file or any derivative of the original file.
 /// The gid will be unique per user + parent file combination.
+/// @param startingHash the hash of the file the model started from.
 /// @return a gid value for this eventlog record.
--(NSNumber*) getFileID
+-(NSNumber*) getFileIDForHash:(NSData*)startingHash
 {
     NSNumber* fileID = [NSNumber numberWithInt:-1];
     
     // Perform a query on the database to get the id of the parent file so we can keep track of how a model progresses.
     // Will create a new value if an id does not exist or it is a new model.
-    NSString* hashVal = [FileIO base64forData:[Model sharedModel].startingHash];
+    NSString* hashVal = [FileIO base64forData:startingHash];
     PFQuery *query = [PFQuery queryWithClassName:CLASS_NAME];
     [query whereKey:ENDING_HASH equalTo: hashVal];
     [query whereKey:USER_ID     equalTo:[PFUser currentUser].username];
@@ -337,73 +360,6 @@ NSString* MODEL_EXPORT_FILE = @"model.mdl";
     return fileID;
 }
 
-/// Will create a new component of type CausalLink, Variable, or Loop and add it to the model.
-/// @param string the input string from the Vensim mdl file that provides specification for the component.
-/// @param loopName the provided name for a loop.  This will be ignored for causal links and variables.
--(void) processComponent: (NSString*) string loopName:(NSString*) loopName
-{
-    // Take each line and parse the data. Unfortunately realatiships do not have a comma between all values
-    // and we need to the position which is the last parameter
-    NSArray* subString = [string componentsSeparatedByString:@","];
-    int value = [[subString objectAtIndex:0] integerValue];
-    
-    // This switch statement in the future would create an instance of each object class and fill in its information
-    switch(value)
-    {
-        case CAUSAL_LINK:
-            [[Model sharedModel] addComponent:[[CausalLink alloc] init:subString]];
-            break;
-            
-        case VARIABLE:
-        {
-            [[Model sharedModel] addComponent:[[Variable alloc]init:subString]];
-            break;
-        }
-            
-        case LOOP:
-        {
-            [[Model sharedModel] addComponent:[[Loop alloc] init:subString varName:loopName]];
-            break;
-        }
-            
-        default:
-            //Do nothing because we are only looking for the three types of components subclasses.
-            break;
-    }
-}
-
-/// Once the file has been read in completely we can finish processing the data.  The causal link parent and child objects upon import point to a string id of the parent and child, instead we would like the parent and child to point to the instance of those Variables.  Likewise, each variable would like to keep track of which CausalLinks are indegree and outdegree.
--(void) updateCausalLinkConnections
-{
-    // Iterate over all ofthe components in the model.
-    for(id obj in [[Model sharedModel] components])
-    {
-        // Only look at objects that are CausalLinks
-        if([obj isMemberOfClass:[CausalLink class]])
-        {
-            // Ensuring the parent and child objects were previously of type NSNumber because they are holding the id.
-            if([[obj parentObject] isKindOfClass:[NSNumber class]])
-            {
-                // Get the parent variable object.  Assign the CausalLink's parent to that object, and update the Varable's list of outdegree links with this CausalLink.
-                Variable* var = [[Model sharedModel] getVariable:[obj parentObject]];
-                [obj setParentObject:var];
-                [var addOutdegreeLink:obj];
-            }
-            
-            if([[obj childObject] isKindOfClass:[NSNumber class]])
-            {
-                // Get the child variable object.  Assign the CausalLink's child to that object, and update the Varable's list of indegree links with this CausalLink.
-                Variable* var = [[Model sharedModel] getVariable:[obj childObject]];
-                [obj setChildObject:var];
-                [var addIndegreeLink:obj];
-            }
-            
-            // Now that the parent and child objects have been updated, we have access to the parent and child locations, so we can create the view that displays the CausalLink.
-            [obj createView];
-        }
-    }
-}
-
 /// Will compute a sha1 hash function on some data.
 /// @param data the data to be hashed.
 /// @param a sha1 hash of data.
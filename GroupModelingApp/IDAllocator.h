@@ -0,0 +1,23 @@
+//
+//  IDAllocator.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/// Hands out the id numbers of the components of a single model.  Safe to use from any thread.
+/// Ids start at 1 and are never reused until the allocator is reset, including ids of deleted components, since the event logs refer to components by id.
+/// Producers that create many components in parallel can reserve a whole block of ids at once instead of taking them one at a time.
+@interface IDAllocator : NSObject
+
+-(id)init;
+-(int) nextID;
+-(int) reserveIDs:(int)count;
+-(void) observeID:(int)idNum;
+-(int) largestID;
+-(void) reset;
+
+@end
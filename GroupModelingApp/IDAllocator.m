@@ -0,0 +1,74 @@
+//
+//  IDAllocator.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <libkern/OSAtomic.h>
+#import "IDAllocator.h"
+
+@implementation IDAllocator
+{
+    /// The largest id handed out or seen so far.  Only changed with atomic operations.
+    volatile int32_t _largestID;
+}
+
+/// Initializes an IDAllocator that has not handed out any ids.
+/// @return a pointer to the newly created IDAllocator.
+-(id)init
+{
+    self = [super init];
+    if(self)
+    {
+        _largestID = 0;
+    }
+    return self;
+}
+
+/// Hands out the next id.
+/// @return an id that has not been handed out or seen before.
+-(int) nextID
+{
+    return OSAtomicIncrement32Barrier(&_largestID);
+}
+
+/// Hands out a block of consecutive ids.
+/// @param count the number of ids to reserve.
+/// @return the first id of the block.  The block is the ids from the first id to the first id + count - 1.
+-(int) reserveIDs:(int)count
+{
+    return OSAtomicAdd32Barrier(count, &_largestID) - count + 1;
+}
+
+/// Records an id that was assigned elsewhere, such as an id read from a file or the largest id written at the end of an exported file, so that it is never handed out.
+/// @param idNum the id that is in use.
+-(void) observeID:(int)idNum
+{
+    int32_t largest;
+    do
+    {
+        largest = _largestID;
+        if(idNum <= largest)
+        {
+            return;
+        }
+    } while(!OSAtomicCompareAndSwap32Barrier(largest, idNum, &_largestID));
+}
+
+/// Gets the largest id handed out or seen so far.  Written to the end of an exported file as -##.
+/// @return the largest id.
+-(int) largestID
+{
+    OSMemoryBarrier();
+    return _largestID;
+}
+
+/// Starts handing out ids from 1 again.  Used when a new file is created or opened.
+-(void) reset
+{
+    OSAtomicAnd32Barrier(0, (volatile uint32_t*)&_largestID);
+}
+
+@end
@@ -8,6 +8,8 @@
 
 #import "Component.h"
 #import "LoopView.h"
+#import "ComponentRecord.h"
+#import "RecordBuilder.h"
 
 /// A subclass of Component containing the data related to a feedback loop of a causal loop diagram. ex. In a diagram on K-12 school attendance, a feedback loop would occur where as "Students Desire to Go to School" increases so does their "Mean daily attendance rate" and as their "Mean Daily attendance rate" increases so does a "Students Desire to Go to School"
 @interface Loop : Component
@@ -18,10 +20,15 @@
 /// The UIView that will contain the graphical representation of the loop.
 @property LoopView* view;
 
--(id)init:(NSArray*)data varName:(NSString*)name;
+-(id)initWithRecord:(ComponentRecord*)record;
+-(ComponentRecord*)createRecord;
+-(void)applyRecord:(ComponentRecord*)record;
+
+-(void) logImport;
 
 -(id) initWithLocation:(CGPoint) location;
 
 -(NSString*)createLoopOutputString;
+-(void)appendLoopOutputTo:(RecordBuilder*)builder;
 
 @end
\ No newline at end of file
@@ -14,63 +14,77 @@
 
 @implementation Loop
 
-/// Enum containing the indicies of an array of strings separated by commas in which the different attributes of a feedback loop in a Vensim mdl file are located.
-enum IndexLocations
-{
-    TYPE    = 0,
-    ID      = 1,
-    XCOORD  = 3,
-    YCOORD  = 4,
-    SYMBOL  = 7,
-    TEXTPOS = 11
-};
-
 @synthesize textPosition = _textPosition;
 @synthesize view         = _view;
 
 /// Initializes the Loop when you are reading from an mdl file.
-/// @param data an array of strings containing all of the data for the feedback loop from a Vensim mdl file.
-/// @param myName the name associated with the feedback loop.  Unlike Variables and CausalLinks, Loop names are located on a different line in the Vensim mdl file from the rest of the loop attributes.
+/// The view is created but not displayed, the Model adds the views of all imported components at once.
+/// @param record the data for the feedback loop from a Vensim mdl file, including the name which Vensim stores on the following line.
 /// @return a pointer to the newly created Loop.
--(id)init:(NSArray*)data varName:(NSString*)myName
+-(id)initWithRecord:(ComponentRecord*)record
 {
-    self = [super init];
+    self = [super initWithIDNum:record.idNum];
     if(self)
     {
-        self.objectType   = [[data objectAtIndex:TYPE] integerValue];
-        self.idNum        = [[data objectAtIndex:ID] integerValue];
-        self.textPosition = [[data objectAtIndex:TEXTPOS] integerValue];
-        
+        self.objectType   = record.objectType;
+        self.textPosition = record.textPosition;
         
         // Create the view to add to the parentView.
-        self.view = [[LoopView  alloc] initWithFrame:CGRectMake([[data objectAtIndex:XCOORD] integerValue],
-                                                                [[data objectAtIndex:YCOORD] integerValue],
+        self.view = [[LoopView  alloc] initWithFrame:CGRectMake(record.xcoord,
+                                                                record.ycoord,
                                                                 SIDE,
                                                                 SIDE)
                                            andParent:self];
         
         // Determines which symbol to display.
-        [self.view setIsClockwise:([[data objectAtIndex:SYMBOL] integerValue] == CLOCKWISE)];
-        
-        // Set the name of the variable, sanitizing escape characters.
-        [self.view setName:[Component sanitizeString:myName]];
-        
-        // Get the root view controller view and add the Variable's view as a subview.
-        [[[Model sharedModel] getViewControllerView] addSubview:self.view];
+        [self.view setIsClockwise:(record.symbol == CLOCKWISE)];
         
-        // Log the import
-        NSString* name     = [NSString stringWithFormat:OBJECT_NAME, self.view.name];
-        NSString* location = [[Model sharedModel]constructLocationDetails:self.view.center];
-        NSString* type     = [NSString stringWithFormat:OBJECT_TYPE,(self.view.isClockwise) ? CLOCKWISE_LABEL : COUNTER_CLOCKWISE_LABEL];
-        
-        NSString* details = [NSString stringWithFormat:@"%@ %@ %@", name, type, location];
-        [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID:IMPORTED_LOOP
-                                                                   andObjectID:self.idNum
-                                                                    andDetails:details]];
+        // Set the name of the loop, escape characters were sanitized when the record was read.
+        [self.view setName:record.name];
     }
     return self;
 }
 
+/// Creates a record of the current state of the Loop that initWithRecord: turns back into the same Loop.
+/// @return the record of the loop.
+-(ComponentRecord*)createRecord
+{
+    ComponentRecord* record = [[ComponentRecord alloc] init];
+    record.objectType   = LOOP;
+    record.idNum        = self.idNum;
+    record.name         = self.view.name;
+    record.xcoord       = (int)lround(self.view.frame.origin.x);
+    record.ycoord       = (int)lround(self.view.frame.origin.y);
+    record.symbol       = (self.view.isClockwise) ? CLOCKWISE : COUNTER_CLOCKWISE;
+    record.textPosition = self.textPosition;
+    return record;
+}
+
+/// Sets the Loop to the state held by a record.  Used when an edit is undone or redone.
+/// @param record the record of the loop, created by createRecord.
+-(void)applyRecord:(ComponentRecord*)record
+{
+    self.textPosition = record.textPosition;
+    self.view.frame   = CGRectMake(record.xcoord, record.ycoord, SIDE, SIDE);
+    [self.view setIsClockwise:(record.symbol == CLOCKWISE)];
+    [self.view setName:record.name];
+    [self.view setNeedsDisplay];
+}
+
+/// Logs the import of the Loop with a formatted description of its name, symbol, and location.
+/// Only used when the event logger is recording imports in verbose mode.
+-(void) logImport
+{
+    NSString* name     = [NSString stringWithFormat:OBJECT_NAME, self.view.name];
+    NSString* location = [self.model constructLocationDetails:self.view.center];
+    NSString* type     = [NSString stringWithFormat:OBJECT_TYPE,(self.view.isClockwise) ? CLOCKWISE_LABEL : COUNTER_CLOCKWISE_LABEL];
+    
+    NSString* details = [NSString stringWithFormat:@"%@ %@ %@", name, type, location];
+    [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID:IMPORTED_LOOP
+                                                               andObjectID:self.idNum
+                                                                andDetails:details]];
+}
+
 /// Initizlizes the Loop when you are adding a brand new variable.
 /// @param location the location of the new object in the frame.
 /// @return a pointer to the newly created Loop.
@@ -91,9 +105,6 @@ enum IndexLocations
         
         // Determines which symbol to display.
         [self.view setIsClockwise:(YES)];
-    
-        // Get the root view controller view and add the Variable's view as a subview.
-        [[[Model sharedModel] getViewControllerView] addSubview:self.view];
     }
     return self;
 }
@@ -105,38 +116,47 @@ enum IndexLocations
 /// [Comment]
 /// @return the string of data for the variable.
 -(NSString*)createLoopOutputString
+{
+    RecordBuilder* builder = [[RecordBuilder alloc] init];
+    [self appendLoopOutputTo:builder];
+    return [builder string];
+}
+
+/// Appends the output record for a Loop to a RecordBuilder, including the line holding its name.
+/// @see createLoopOutputString for the pattern of the record.
+/// @param builder the builder to append the record to.
+-(void)appendLoopOutputTo:(RecordBuilder*)builder
 {
     // Initialize with the type.
-    NSString* result = [NSString stringWithFormat:@"%d", LOOP];
+    [builder appendInt:LOOP];
     
     // Add the id number.
-    result = [result stringByAppendingString:[NSString stringWithFormat:@",%d", self.idNum]];
+    [builder appendField:self.idNum];
     
     // Add misc default.
-    result = [result stringByAppendingString:@",0"];
+    [builder appendField:0];
     
     // Add x coordinate.
-    result = [result stringByAppendingString:[NSString stringWithFormat:@",%d", (int)self.view.center.x]];
+    [builder appendField:(int)self.view.center.x];
     
     // Add y coordinate.
-    result = [result stringByAppendingString:[NSString stringWithFormat:@",%d", (int)self.view.center.y]];
+    [builder appendField:(int)self.view.center.y];
     
     // Add misc. defaults.
-    result = [result stringByAppendingString:LOOP_DEFAULTS1];
+    [builder appendString:LOOP_DEFAULTS1];
     
     // Add symbol
     if(self.view.isClockwise)
-        result = [result stringByAppendingString:[NSString stringWithFormat:@",%d",CLOCKWISE]];
+        [builder appendField:CLOCKWISE];
     else
-        result = [result stringByAppendingString:[NSString stringWithFormat:@",%d",COUNTER_CLOCKWISE]];
+        [builder appendField:COUNTER_CLOCKWISE];
     
     // Add misc. defaults.
-    result = [result stringByAppendingString:LOOP_DEFAULTS2];
+    [builder appendString:LOOP_DEFAULTS2];
     
     // Add the name.
-    result = [result stringByAppendingString:[NSString stringWithFormat:@"\n%@", self.view.name]];
-    
-    return result;
+    [builder appendLiteral:"\n"];
+    [builder appendString:self.view.name];
 }
 
 @end
\ No newline at end of file
@@ -0,0 +1,28 @@
+//
+//  LoopCycle.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/// A feedback loop that exists among the Variables and CausalLinks of a model, found by the LoopFinder.
+/// Unlike a Loop, which is a label placed by the user, a LoopCycle is never displayed or exported.
+@interface LoopCycle : NSObject
+
+/// The ids of the Variables around the loop, starting from the one with the smallest index in the finder.
+@property NSArray* variableIDs;
+
+/// The ids of the CausalLinks around the loop.  The link at each index leaves the variable at the same index, the last one closes the loop.
+@property NSArray* linkIDs;
+
+/// Whether the loop is reinforcing.  A loop is reinforcing when it has an even number of negative links, and balancing otherwise.
+@property bool isReinforcing;
+
+-(id)initWithVariableIDs:(NSArray*)variableIDs linkIDs:(NSArray*)linkIDs isReinforcing:(bool)isReinforcing;
+-(int) length;
+-(NSString*) polarityLabel;
+
+@end
@@ -0,0 +1,49 @@
+//
+//  LoopCycle.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "Constants.h"
+#import "LoopCycle.h"
+
+@implementation LoopCycle
+
+@synthesize variableIDs   = _variableIDs;
+@synthesize linkIDs       = _linkIDs;
+@synthesize isReinforcing = _isReinforcing;
+
+/// Initializes a LoopCycle.
+/// @param variableIDs the ids of the Variables around the loop.
+/// @param linkIDs the ids of the CausalLinks around the loop.
+/// @param isReinforcing true if the loop is reinforcing, false if it is balancing.
+/// @return a pointer to the newly created LoopCycle.
+-(id)initWithVariableIDs:(NSArray*)variableIDs linkIDs:(NSArray*)linkIDs isReinforcing:(bool)isReinforcing
+{
+    self = [super init];
+    if(self)
+    {
+        self.variableIDs   = variableIDs;
+        self.linkIDs       = linkIDs;
+        self.isReinforcing = isReinforcing;
+    }
+    return self;
+}
+
+/// Gets the number of CausalLinks around the loop.
+/// @return the length of the loop.
+-(int) length
+{
+    return (int)self.linkIDs.count;
+}
+
+/// Gets the label Vensim uses for the polarity of a loop.
+/// @return R for a reinforcing loop, B for a balancing loop.
+-(NSString*) polarityLabel
+{
+    return (self.isReinforcing) ? REINFORCING_LABEL : BALANCING_LABEL;
+}
+
+@end
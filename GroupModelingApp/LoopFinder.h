@@ -0,0 +1,49 @@
+//
+//  LoopFinder.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "LoopCycle.h"
+
+@class Model;
+
+/// Finds the feedback loops that exist among the Variables and CausalLinks of a model, and whether each one is reinforcing or balancing.
+/// The finder copies the links of the model into plain arrays when it is created, which has to be done on the main thread.  The search itself does not touch the model, so it runs on a background queue while the model keeps being edited.
+/// Every elementary cycle is found exactly once, using Johnson's algorithm within each strongly connected group of variables.  Dense models can have an enormous number of loops, so the search stops after maxLoops loops, and only follows loops of up to maxLength links.
+@interface LoopFinder : NSObject
+
+/// The search stops once this many loops have been found.
+@property int maxLoops;
+
+/// Only loops with at most this many links are found.
+@property int maxLength;
+
+/// The asynchronous queue the search runs on.
+@property dispatch_queue_t loopQueue;
+
+/// Whether the search has been cancelled.
+@property volatile bool isCancelled;
+
+/// Every loop found so far.
+@property NSMutableArray* loops;
+
+/// The number of reinforcing loops found so far.
+@property int reinforcingCount;
+
+/// The number of balancing loops found so far.
+@property int balancingCount;
+
+/// Whether the search stopped at maxLoops, so the model may have more loops than were found.
+@property bool isTruncated;
+
+-(id)initWithModel:(Model*)model;
+-(void)findLoopsWithProgress:(void (^)(NSArray* loops))progress completion:(void (^)(LoopFinder* finder))completion;
+-(bool)findLoops:(void (^)(NSArray* loops))found;
+-(void)cancel;
+-(NSString*)summary;
+
+@end
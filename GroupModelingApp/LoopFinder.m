@@ -0,0 +1,451 @@
+//
+//  LoopFinder.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "Constants.h"
+#import "LoopFinder.h"
+#import "Model.h"
+
+@implementation LoopFinder
+{
+    /// The number of Variables in the model.  Variables are referred to by their index, in the order they were added to the model.
+    int _variableCount;
+    
+    /// The id of the Variable at each index.
+    NSMutableData* _variableIDs;
+    
+    /// The outdegree links of the Variable at each index are the edges from _edgeStarts[index] up to _edgeStarts[index + 1].
+    NSMutableData* _edgeStarts;
+    
+    /// The index of the child Variable of each edge.
+    NSMutableData* _edgeTargets;
+    
+    /// The id of the CausalLink of each edge.
+    NSMutableData* _edgeLinkIDs;
+    
+    /// Whether the CausalLink of each edge is negative.
+    NSMutableData* _edgeIsNegative;
+    
+    // The state of the search in progress, only set during findLoops:.
+    int             _start;          // The index of the variable every loop of the current search starts from.
+    int*            _group;          // The strongly connected group of each variable.
+    bool*           _blocked;        // Whether each variable is blocked.
+    NSMutableArray* _blockedBy;      // The variables waiting for each variable to be unblocked, as an NSMutableIndexSet.
+    int*            _variableStack;  // The variables of the path being followed.
+    int*            _edgeStack;      // The edge leaving each variable of the path.
+    int             _stackCount;     // The number of variables on the path.
+    NSMutableArray* _batch;          // The loops found since the last batch was handed out.
+    void (^_found)(NSArray*);        // The block the batches are handed to.
+}
+
+@synthesize maxLoops         = _maxLoops;
+@synthesize maxLength        = _maxLength;
+@synthesize loopQueue        = _loopQueue;
+@synthesize isCancelled      = _isCancelled;
+@synthesize loops            = _loops;
+@synthesize reinforcingCount = _reinforcingCount;
+@synthesize balancingCount   = _balancingCount;
+@synthesize isTruncated      = _isTruncated;
+
+/// Initializes the LoopFinder with the Variables and CausalLinks of a model as they are now.  Must be called on the main thread.
+/// @param model the model to find the loops of.
+/// @return a pointer to the newly created LoopFinder.
+-(id)initWithModel:(Model*)model
+{
+    self = [super init];
+    if(self)
+    {
+        self.maxLoops         = LOOP_FINDER_MAX_LOOPS;
+        self.maxLength        = LOOP_FINDER_MAX_LENGTH;
+        self.loopQueue        = dispatch_queue_create(LOOP_QUEUE, DISPATCH_QUEUE_SERIAL);
+        self.isCancelled      = NO;
+        self.loops            = [[NSMutableArray alloc] init];
+        self.reinforcingCount = 0;
+        self.balancingCount   = 0;
+        self.isTruncated      = NO;
+        
+        // Number the variables, and find the index of each from its id.
+        _variableCount = (int)model.variables.count;
+        _variableIDs = [[NSMutableData alloc] initWithLength:_variableCount * sizeof(int)];
+        NSMutableData* indexes = [[NSMutableData alloc] initWithLength:([model.idAllocator largestID] + 1) * sizeof(int)];
+        int* variableIDs = _variableIDs.mutableBytes;
+        int* indexOfID   = indexes.mutableBytes;
+        int count = 0;
+        int edgeCount = 0;
+        for(Variable* var in model.variables)
+        {
+            variableIDs[count] = var.idNum;
+            indexOfID[var.idNum] = count++;
+            edgeCount += (int)var.outdegreeLinks.count;
+        }
+        
+        // Lay out the outdegree links of every variable one after another.
+        _edgeStarts     = [[NSMutableData alloc] initWithLength:(_variableCount + 1) * sizeof(int)];
+        _edgeTargets    = [[NSMutableData alloc] initWithLength:edgeCount * sizeof(int)];
+        _edgeLinkIDs    = [[NSMutableData alloc] initWithLength:edgeCount * sizeof(int)];
+        _edgeIsNegative = [[NSMutableData alloc] initWithLength:edgeCount * sizeof(bool)];
+        int*  edgeStarts     = _edgeStarts.mutableBytes;
+        int*  edgeTargets    = _edgeTargets.mutableBytes;
+        int*  edgeLinkIDs    = _edgeLinkIDs.mutableBytes;
+        bool* edgeIsNegative = _edgeIsNegative.mutableBytes;
+        int edge = 0;
+        for(int i = 0; i < _variableCount; ++i)
+        {
+            edgeStarts[i] = edge;
+            Variable* var = (Variable*)[model.variables componentWithID:variableIDs[i]];
+            for(CausalLink* link in var.outdegreeLinks)
+            {
+                // A link whose child is not a Variable of the model can not be part of a loop.
+                Variable* child = link.childObject;
+                if(![child isKindOfClass:[Variable class]] || ![model.variables containsComponent:child])
+                {
+                    continue;
+                }
+                edgeTargets[edge]    = indexOfID[child.idNum];
+                edgeLinkIDs[edge]    = link.idNum;
+                edgeIsNegative[edge] = [link.view.polarity isEqualToString:MINUS_SYMBOL];
+                ++edge;
+            }
+        }
+        edgeStarts[_variableCount] = edge;
+    }
+    return self;
+}
+
+/// Runs the search on the loop queue.
+/// The progress and completion blocks are always called on the main thread.  The completion block is not called if the search was cancelled.
+/// @param progress called with each batch of loops as they are found. May be nil.
+/// @param completion called once the search has finished.
+-(void)findLoopsWithProgress:(void (^)(NSArray* loops))progress completion:(void (^)(LoopFinder* finder))completion
+{
+    // Forward batches from the loop queue to the main thread.
+    void (^mainProgress)(NSArray*) = nil;
+    if(progress)
+    {
+        mainProgress = ^(NSArray* loops) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                progress(loops);
+            });
+        };
+    }
+    
+    dispatch_async(self.loopQueue, ^{
+        [self findLoops:mainProgress];
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            // A cancel may have come in after the search finished, check again on the main thread.
+            if(!self.isCancelled)
+            {
+                completion(self);
+            }
+        });
+    });
+}
+
+/// Runs the search on the calling thread.
+/// @param found called with each batch of loops as they are found, on the calling thread.  May be nil.
+/// @return true if the search finished, false if it was cancelled.
+-(bool)findLoops:(void (^)(NSArray* loops))found
+{
+    int n = _variableCount;
+    const int* edgeStarts  = _edgeStarts.bytes;
+    const int* edgeTargets = _edgeTargets.bytes;
+    
+    // Find the strongly connected groups of variables.  A loop never leaves the group it starts in.
+    NSMutableData* group = [[NSMutableData alloc] initWithLength:n * sizeof(int)];
+    int groupCount = [self groupVariables:group.mutableBytes];
+    
+    // A group with a single variable only has a loop if the variable links to itself.
+    NSMutableData* groupSizes = [[NSMutableData alloc] initWithLength:groupCount * sizeof(int)];
+    int* sizes = groupSizes.mutableBytes;
+    _group = group.mutableBytes;
+    for(int v = 0; v < n; ++v)
+    {
+        ++sizes[_group[v]];
+    }
+    
+    NSMutableData* blocked       = [[NSMutableData alloc] initWithLength:n * sizeof(bool)];
+    NSMutableData* variableStack = [[NSMutableData alloc] initWithLength:(self.maxLength + 1) * sizeof(int)];
+    NSMutableData* edgeStack     = [[NSMutableData alloc] initWithLength:(self.maxLength + 1) * sizeof(int)];
+    _blocked       = blocked.mutableBytes;
+    _variableStack = variableStack.mutableBytes;
+    _edgeStack     = edgeStack.mutableBytes;
+    _blockedBy     = [[NSMutableArray alloc] initWithCapacity:n];
+    for(int v = 0; v < n; ++v)
+    {
+        [_blockedBy addObject:[[NSMutableIndexSet alloc] init]];
+    }
+    _batch = [[NSMutableArray alloc] init];
+    _found = found;
+    
+    // Every loop is found from the variable with the smallest index on it, searching only variables with a larger index.
+    for(_start = 0; _start < n && ![self shouldStop]; ++_start)
+    {
+        bool hasLoop = sizes[_group[_start]] > 1;
+        for(int e = edgeStarts[_start]; e < edgeStarts[_start + 1] && !hasLoop; ++e)
+        {
+            hasLoop = (edgeTargets[e] == _start);
+        }
+        if(!hasLoop || self.maxLength < 1)
+        {
+            continue;
+        }
+        
+        for(int v = _start; v < n; ++v)
+        {
+            if(_group[v] == _group[_start])
+            {
+                _blocked[v] = NO;
+                [[_blockedBy objectAtIndex:v] removeAllIndexes];
+            }
+        }
+        _stackCount = 0;
+        [self circuit:_start];
+    }
+    
+    [self flushBatch];
+    _group = NULL;
+    _blocked = NULL;
+    _variableStack = NULL;
+    _edgeStack = NULL;
+    _blockedBy = nil;
+    _batch = nil;
+    _found = nil;
+    return !self.isCancelled;
+}
+
+/// Searches for every loop through the start variable that continues from a variable.
+/// A variable that can not reach the start variable stays blocked until one of the variables it leads to is unblocked, so that dead ends are not searched again.
+/// A variable whose search was cut short by maxLength is treated as if it reached the start variable, since it may still reach it over a shorter path.
+/// @param v the index of the variable.
+/// @return true if a loop was found, or may have been missed because of maxLength.
+-(bool)circuit:(int)v
+{
+    const int* edgeStarts  = _edgeStarts.bytes;
+    const int* edgeTargets = _edgeTargets.bytes;
+    
+    bool found = NO;
+    _variableStack[_stackCount++] = v;
+    _blocked[v] = YES;
+    
+    for(int e = edgeStarts[v]; e < edgeStarts[v + 1]; ++e)
+    {
+        if([self shouldStop])
+        {
+            break;
+        }
+        
+        int w = edgeTargets[e];
+        if(w < _start || _group[w] != _group[_start])
+        {
+            continue;
+        }
+        
+        _edgeStack[_stackCount - 1] = e;
+        if(w == _start)
+        {
+            [self reportLoop];
+            found = YES;
+        }
+        else if(!_blocked[w])
+        {
+            if(_stackCount >= self.maxLength || [self circuit:w])
+            {
+                found = YES;
+            }
+        }
+    }
+    
+    if(found)
+    {
+        [self unblock:v];
+    }
+    else
+    {
+        for(int e = edgeStarts[v]; e < edgeStarts[v + 1]; ++e)
+        {
+            int w = edgeTargets[e];
+            if(w >= _start && _group[w] == _group[_start])
+            {
+                [[_blockedBy objectAtIndex:w] addIndex:v];
+            }
+        }
+    }
+    
+    --_stackCount;
+    return found;
+}
+
+/// Unblocks a variable, along with every blocked variable that was waiting on it.
+/// @param v the index of the variable.
+-(void)unblock:(int)v
+{
+    _blocked[v] = NO;
+    NSMutableIndexSet* waiting = [_blockedBy objectAtIndex:v];
+    NSIndexSet* unblocked = [waiting copy];
+    [waiting removeAllIndexes];
+    [unblocked enumerateIndexesUsingBlock:^(NSUInteger w, BOOL *stop) {
+        if(_blocked[w])
+        {
+            [self unblock:(int)w];
+        }
+    }];
+}
+
+/// Adds the loop made by the variables and links on the stack to the results.
+-(void)reportLoop
+{
+    const int*  variableIDs    = _variableIDs.bytes;
+    const int*  edgeLinkIDs    = _edgeLinkIDs.bytes;
+    const bool* edgeIsNegative = _edgeIsNegative.bytes;
+    
+    NSMutableArray* varIDs  = [[NSMutableArray alloc] initWithCapacity:_stackCount];
+    NSMutableArray* linkIDs = [[NSMutableArray alloc] initWithCapacity:_stackCount];
+    int negativeCount = 0;
+    for(int i = 0; i < _stackCount; ++i)
+    {
+        int e = _edgeStack[i];
+        [varIDs addObject:[NSNumber numberWithInt:variableIDs[_variableStack[i]]]];
+        [linkIDs addObject:[NSNumber numberWithInt:edgeLinkIDs[e]]];
+        negativeCount += (edgeIsNegative[e]) ? 1 : 0;
+    }
+    
+    LoopCycle* loop = [[LoopCycle alloc] initWithVariableIDs:varIDs linkIDs:linkIDs isReinforcing:(negativeCount % 2 == 0)];
+    if(loop.isReinforcing)
+        ++self.reinforcingCount;
+    else
+        ++self.balancingCount;
+    [self.loops addObject:loop];
+    
+    [_batch addObject:loop];
+    if(_batch.count >= LOOP_FINDER_BATCH_SIZE)
+    {
+        [self flushBatch];
+    }
+    
+    if((int)self.loops.count >= self.maxLoops)
+    {
+        self.isTruncated = YES;
+    }
+}
+
+/// Hands the loops found since the last batch to the found block.
+-(void)flushBatch
+{
+    if(_batch.count > 0 && _found)
+    {
+        _found([_batch copy]);
+    }
+    [_batch removeAllObjects];
+}
+
+/// Whether the search has to stop, either because it was cancelled or because maxLoops loops have been found.
+/// @return true if the search has to stop.
+-(bool)shouldStop
+{
+    return self.isCancelled || self.isTruncated;
+}
+
+/// Finds the strongly connected groups of variables using Tarjan's algorithm, without recursion so that long chains of variables can not overflow the stack.
+/// @param group set to the group of the variable at each index.
+/// @return the number of groups.
+-(int)groupVariables:(int*)group
+{
+    int n = _variableCount;
+    const int* edgeStarts  = _edgeStarts.bytes;
+    const int* edgeTargets = _edgeTargets.bytes;
+    
+    NSMutableData* order    = [[NSMutableData alloc] initWithLength:n * sizeof(int)];
+    NSMutableData* lowLink  = [[NSMutableData alloc] initWithLength:n * sizeof(int)];
+    NSMutableData* onStack  = [[NSMutableData alloc] initWithLength:n * sizeof(bool)];
+    NSMutableData* stack    = [[NSMutableData alloc] initWithLength:n * sizeof(int)];
+    NSMutableData* calls    = [[NSMutableData alloc] initWithLength:n * sizeof(int)];
+    NSMutableData* nextEdge = [[NSMutableData alloc] initWithLength:n * sizeof(int)];
+    int*  orderOf   = order.mutableBytes;     // The order each variable was visited in.
+    int*  low       = lowLink.mutableBytes;   // The earliest visited variable each variable can reach.
+    bool* isOnStack = onStack.mutableBytes;
+    int*  members   = stack.mutableBytes;     // The variables not yet assigned to a group.
+    int*  callStack = calls.mutableBytes;     // The variables being visited, in place of recursion.
+    int*  edgeOf    = nextEdge.mutableBytes;  // The next link to follow from each variable.
+    
+    // An order of 0 means the variable has not been visited yet.
+    int visited = 0;
+    int memberCount = 0;
+    int groupCount = 0;
+    for(int root = 0; root < n; ++root)
+    {
+        if(orderOf[root] != 0)
+        {
+            continue;
+        }
+        
+        int callCount = 0;
+        callStack[callCount++] = root;
+        orderOf[root] = low[root] = ++visited;
+        edgeOf[root] = edgeStarts[root];
+        members[memberCount++] = root;
+        isOnStack[root] = YES;
+        
+        while(callCount > 0)
+        {
+            int v = callStack[callCount - 1];
+            if(edgeOf[v] < edgeStarts[v + 1])
+            {
+                int w = edgeTargets[edgeOf[v]++];
+                if(orderOf[w] == 0)
+                {
+                    orderOf[w] = low[w] = ++visited;
+                    edgeOf[w] = edgeStarts[w];
+                    members[memberCount++] = w;
+                    isOnStack[w] = YES;
+                    callStack[callCount++] = w;
+                }
+                else if(isOnStack[w])
+                {
+                    low[v] = MIN(low[v], orderOf[w]);
+                }
+                continue;
+            }
+            
+            // Every link of the variable has been followed.  It is the root of a group if it can not reach a variable visited before it.
+            if(low[v] == orderOf[v])
+            {
+                int w;
+                do
+                {
+                    w = members[--memberCount];
+                    isOnStack[w] = NO;
+                    group[w] = groupCount;
+                } while(w != v);
+                ++groupCount;
+            }
+            
+            --callCount;
+            if(callCount > 0)
+            {
+                int parent = callStack[callCount - 1];
+                low[parent] = MIN(low[parent], low[v]);
+            }
+        }
+    }
+    return groupCount;
+}
+
+/// Stops the search.  The completion block of findLoopsWithProgress:completion: will not be called.
+-(void)cancel
+{
+    self.isCancelled = YES;
+}
+
+/// Describes the result of the search for the event log.
+/// @return the number of loops found of each polarity, and whether the search stopped at maxLoops.
+-(NSString*)summary
+{
+    return [NSString stringWithFormat:LOOPS_FOUND_DETAILS, (int)self.loops.count, self.reinforcingCount, self.balancingCount, (self.isTruncated) ? 1 : 0];
+}
+
+@end
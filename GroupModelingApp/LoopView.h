@@ -12,10 +12,10 @@
 @interface LoopView : UIView
 
 /// The name of the loop.
-@property NSString* name;
+@property (nonatomic) NSString* name;
 
 /// Determines if the symbol is a clockwise loop
-@property bool isClockwise;
+@property (nonatomic) bool isClockwise;
 
 /// Pointer to the parent of this view.
 @property id parent;
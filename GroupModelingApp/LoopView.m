@@ -8,6 +8,7 @@
 
 #import "Constants.h"
 #import "EventLogger.h"
+#import "Loop.h"
 #import "LoopView.h"
 #import "Model.h"
 #import "ModelSectionViewController.h"
@@ -38,6 +39,38 @@
     return self;
 }
 
+/// Sets the name of the loop.  Part of the sketch record of the loop.
+/// @param name the new name of the loop.
+-(void)setName:(NSString*)name
+{
+    _name = name;
+    [(Loop*)self.parent invalidateRecord];
+}
+
+/// Sets the direction of the loop.  Part of the sketch record of the loop.
+/// @param isClockwise true if the loop points clockwise.
+-(void)setIsClockwise:(bool)isClockwise
+{
+    _isClockwise = isClockwise;
+    [(Loop*)self.parent invalidateRecord];
+}
+
+/// Moves the view.  The location is part of the sketch record of the loop.  This is an overridden method.
+/// @param center the new center of the view.
+-(void)setCenter:(CGPoint)center
+{
+    [super setCenter:center];
+    [(Loop*)self.parent invalidateRecord];
+}
+
+/// Moves or resizes the view.  The location is part of the sketch record of the loop.  This is an overridden method.
+/// @param frame the new frame of the view.
+-(void)setFrame:(CGRect)frame
+{
+    [super setFrame:frame];
+    [(Loop*)self.parent invalidateRecord];
+}
+
 /// Draws the receiver’s image within the passed-in rectangle.  This is an overridden method.
 /// @param rect the frame of the view in which objects can be drawn.
 -(void)drawRect:(CGRect)rect
@@ -103,11 +136,15 @@
            alignment: NSTextAlignmentCenter];
 }
 
-/// Logs event at the beginning of moving the loop.
+/// Logs event at the beginning of moving the loop, and opens an undo step for the move.
 /// @param touches the set of touch events registered by the application.
 /// @param event the UIEvent that fired the the method call.
 -(void)touchesBegan:(NSSet *)touches withEvent:(UIEvent *)event
 {
+    UndoHistory* history = [Model sharedModel].history;
+    [history beginStep];
+    [history willChangeComponent:(Loop*)self.parent];
+
     [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID:BEGIN_LOOP_MOVE
                                                                andObjectID:[(Loop*)self.parent idNum]
                                                                 andDetails:[[Model sharedModel] constructLocationDetails:[touches.anyObject locationInView:self.superview]]]];
@@ -127,7 +164,7 @@
                                                                 andDetails:[[Model sharedModel] constructLocationDetails:self.center]]];
 }
 
-/// Logs event at the end of moving the loop.
+/// Logs event at the end of moving the loop, and closes the undo step of the move.
 /// @param touches the set of touch events registered by the application.
 /// @param event the UIEvent that fired the the method call.
 -(void)touchesEnded:(NSSet *)touches withEvent:(UIEvent *)event
@@ -135,6 +172,15 @@
     [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID:END_LOOP_MOVE
                                                                andObjectID:[(Loop*)self.parent idNum]
                                                                 andDetails:[[Model sharedModel] constructLocationDetails:[touches.anyObject locationInView:self.superview]]]];
+    [[Model sharedModel].history endStepWithDescID:END_LOOP_MOVE andObjectID:[(Loop*)self.parent idNum]];
+}
+
+/// Closes the undo step of the move when the touch is taken over by a gesture, such as a tap.  A step that did not move the loop is dropped.
+/// @param touches the set of touch events registered by the application.
+/// @param event the UIEvent that fired the the method call.
+-(void)touchesCancelled:(NSSet *)touches withEvent:(UIEvent *)event
+{
+    [[Model sharedModel].history endStepWithDescID:END_LOOP_MOVE andObjectID:[(Loop*)self.parent idNum]];
 }
 
 /// Will open up the menu of options for the object on a single tap.
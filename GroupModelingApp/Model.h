@@ -8,17 +8,34 @@
 
 #import <Foundation/Foundation.h>
 #import "CausalLink.h"
+#import "ComponentStore.h"
 #import "ControlParameters.h"
 #import "DefaultParameters.h"
+#import "IDAllocator.h"
 #import "Loop.h"
+#import "ModelGraph.h"
+#import "ModelJournal.h"
+#import "ModelSnapshot.h"
+#import "ModelTransaction.h"
+#import "UndoHistory.h"
 #import "Variable.h"
 
 
 /// This class is responsible for holding all aspects of a causal loop diagram model. This includes all causal links, variables, feedback loops, simulation parameters, and default parameters.
+/// The model being edited on screen is the sharedModel.  Any number of other models can be created to hold files that are not displayed, such as a file being compared against the current model.
 @interface Model : NSObject
 
-/// An array that contains all variables, causal links, and feedback loops of the model.
-@property NSMutableArray* components;
+/// All variables, causal links, and feedback loops of the model in the order they were added, which is the order they are written to a file.
+@property ComponentStore* components;
+
+/// The variables of the model in the order they were added.
+@property ComponentStore* variables;
+
+/// The causal links of the model in the order they were added.
+@property ComponentStore* causalLinks;
+
+/// The feedback loops of the model in the order they were added.
+@property ComponentStore* loops;
 
 /// An instance of DefaultParameters which contains the Vensim default parameters for the model such as font and size.
 @property DefaultParameters* defaultParams;
@@ -26,6 +43,24 @@
 /// An instance of ControlParameters which contains the Vensim control parameters which specify how the simulation runs.
 @property ControlParameters* controlParams;
 
+/// Hands out the id numbers of new components of the model.
+@property IDAllocator* idAllocator;
+
+/// The view the components of the model are displayed in.  nil for a model that is not displayed, in which case the views of its components are never added to a superview.
+@property UIView* canvas;
+
+/// The journal that records the edits to the model.  nil for a model whose edits do not need to survive the app being terminated.
+@property (nonatomic) ModelJournal* journal;
+
+/// The last snapshot taken of the model.  nil once the model has changed since, so that a snapshot of an unchanged model is reused.
+@property ModelSnapshot* lastSnapshot;
+
+/// The edits collected since beginTransaction.  nil when no transaction is open.
+@property ModelTransaction* transaction;
+
+/// The steps the user can undo and redo.  nil for a model that is not edited on screen.
+@property UndoHistory* history;
+
 /// A hash string of the file that was imported from Dropbox. Will be null if brand new file.
 @property NSData* startingHash;
 
@@ -34,25 +69,46 @@
 
 // Methods for the entire model.
 +(Model*) sharedModel;
+-(id) init;
+-(id) initWithGraph:(ModelGraph*) graph;
 -(void) clearModel;
 -(NSString*) constructLocationDetails:(CGPoint) location;
 
+// Import methods.
+-(void) loadGraph:(ModelGraph*) graph;
+-(void) createComponents:(ModelGraph*) graph;
+-(void) logImport:(ModelGraph*) graph;
+-(void) connectCausalLinks;
+-(void) materializeViews;
+-(void) displayComponent:(id) obj;
+-(void) logImportSummary:(ModelGraph*) graph;
+
 // Export methods.
--(NSMutableArray*) createVariableMap;
--(NSMutableArray*) createComponentsExport;
+-(ModelSnapshot*) snapshot;
 
 // Adding objects.
 -(int) addCasualLinkWithParent:(Variable*) parent andChild:(Variable*) child;
 -(void) addComponent:(id) var;
+-(id) addComponentWithRecord:(ComponentRecord*) record;
+-(void) insertComponent:(id) obj;
+-(void) removeComponent:(id) obj;
+-(void) componentChanged:(id) obj;
 
 // Deleting objects.
 -(int) deleteCausalLink:(id) linkView;
 -(int) deleteLoop:(id) loopView;
 -(int) deleteVariable:(id) variableView;
+-(void) removeVariable:(Variable*) var withDetails:(NSMutableString*) details;
+-(void) removeView:(UIView*) view;
+
+// Transactions.
+-(void) beginTransaction;
+-(void) commitTransaction:(NSString*) action;
 
 // Getters.
--(UIView*) getViewControllerView;
 -(UIViewController*) getViewController;
+-(Component*) getComponent:(int) idNum;
+-(ComponentStore*) storeForComponent:(id) obj;
 -(Variable*) getVariable:(NSNumber*) idNumber;
 -(Variable*) getVariableAtPoint:(CGPoint) point;
 
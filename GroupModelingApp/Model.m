@@ -12,58 +12,112 @@
 
 @implementation Model
 
-@synthesize components    = _components;
-@synthesize defaultParams = _defaultParams;
-@synthesize controlParams = _controlParams;
-@synthesize startingHash  = _startingHash;
-@synthesize endingHash    = _endingHash;
-
-/// Forces the Model to be a singleton class.
-/// @return a pointer to the single instance of the model.
+@synthesize components     = _components;
+@synthesize variables      = _variables;
+@synthesize causalLinks    = _causalLinks;
+@synthesize loops          = _loops;
+@synthesize defaultParams  = _defaultParams;
+@synthesize controlParams  = _controlParams;
+@synthesize idAllocator    = _idAllocator;
+@synthesize canvas         = _canvas;
+@synthesize journal        = _journal;
+@synthesize lastSnapshot   = _lastSnapshot;
+@synthesize transaction    = _transaction;
+@synthesize history        = _history;
+@synthesize startingHash   = _startingHash;
+@synthesize endingHash     = _endingHash;
+
+/// Gets the model being edited on screen.  Its edits are recorded in the ModelJournal and the UndoHistory, and it is displayed once the ModelSectionViewController sets its canvas.
+/// @return a pointer to the single instance of the on screen model.
 + (Model*)sharedModel {
     static Model *sharedModel = nil;
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
         sharedModel = [[self alloc] init];
-        sharedModel.components    = [[NSMutableArray alloc]init];
-        sharedModel.defaultParams = [[DefaultParameters alloc] init:@""];
-        sharedModel.controlParams = [[ControlParameters alloc] init];
-        sharedModel.startingHash  = [[NSData alloc]init];
-        sharedModel.endingHash    = [[NSData alloc]init];
+        sharedModel.journal = [ModelJournal sharedModelJournal];
+        sharedModel.history = [[UndoHistory alloc] initWithModel:sharedModel];
     });
     return sharedModel;
 }
 
+/// Initializes an empty model that is not displayed and does not record its edits.
+/// @return a pointer to the newly created model.
+-(id) init
+{
+    self = [super init];
+    if(self)
+    {
+        self.components     = [[ComponentStore alloc]init];
+        self.variables      = [[ComponentStore alloc]init];
+        self.causalLinks    = [[ComponentStore alloc]init];
+        self.loops          = [[ComponentStore alloc]init];
+        self.defaultParams  = [[DefaultParameters alloc] init:@""];
+        self.controlParams  = [[ControlParameters alloc] init];
+        self.idAllocator    = [[IDAllocator alloc] init];
+        self.startingHash   = [[NSData alloc]init];
+        self.endingHash     = [[NSData alloc]init];
+    }
+    return self;
+}
+
+/// Attaches the journal that records the edits to the model, so the journal reads the largest id and starting hash of this model.
+/// @param journal the journal, nil to stop recording the edits.
+-(void) setJournal:(ModelJournal*) journal
+{
+    _journal.model = nil;
+    _journal       = journal;
+    _journal.model = self;
+}
+
+/// Initializes a model holding the components of a parsed Vensim mdl file, without logging the import or displaying it.
+/// @param graph the parsed contents of the mdl file.
+/// @return a pointer to the newly created model.
+-(id) initWithGraph:(ModelGraph*) graph
+{
+    self = [self init];
+    if(self)
+    {
+        [self createComponents:graph];
+        [self connectCausalLinks];
+    }
+    return self;
+}
+
 /// Clears the model when you need to create or load a brand new file.
 -(void) clearModel
 {
     // Remove the views representing the objects.
-    for(Component* compo in self.components)
+    for(Loop* loop in self.loops)
     {
-        if([compo isMemberOfClass:[Loop class]])
-        {
-            [[(Loop*)compo view] removeFromSuperview];
-        }
-        else if([compo isMemberOfClass:[Variable class]])
-        {
-            [[(Variable*)compo view] removeFromSuperview];
-        }
-        else if([compo isMemberOfClass:[CausalLink class]])
-        {
-            [[(CausalLink*)compo view] removeFromSuperview];
-        }
+        [loop.view removeFromSuperview];
+    }
+    for(Variable* var in self.variables)
+    {
+        [var.view removeFromSuperview];
+    }
+    for(CausalLink* link in self.causalLinks)
+    {
+        [link.view removeFromSuperview];
     }
     // Remove all components in the model.
-    [self.components removeAllObjects];
+    [self.components removeAllComponents];
+    [self.variables removeAllComponents];
+    [self.causalLinks removeAllComponents];
+    [self.loops removeAllComponents];
     self.defaultParams.params = @"";
     [self.controlParams.params removeAllObjects];
     
     // Reset the id counter for a brand new model.
-    [Component resetIDCounter];
+    [self.idAllocator reset];
     
     // Clear out the hashes.
     self.startingHash = [NSData data];
     self.endingHash   = [NSData data];
+    self.lastSnapshot = nil;
+    
+    // Start the edit journal over for the blank model, the edits of the previous model can no longer be undone.
+    [self.journal resetWithGraph:[[ModelGraph alloc] init]];
+    [self.history clear];
 }
 
 /// Constructs the details message for all moving events.
@@ -74,51 +128,353 @@
     return [[NSString alloc]initWithFormat:COORDINATES, (int)location.x, (int)location.y];
 }
 
-/// Iterates over all of the Variables in the model and constructs the Vensim Function of() map for each one.
-/// @return an array of strings that hold all of the output text of the variable maps.
--(NSMutableArray*) createVariableMap
+/// Creates the components of a parsed Vensim mdl file and displays them.
+/// The components are all created before any of their views are displayed, so that the views can be added to the view controller's view in a single batch.
+/// @param graph the parsed contents of the mdl file.
+-(void) loadGraph:(ModelGraph*) graph
 {
-    NSMutableArray* map = [[NSMutableArray alloc]init];
-    for(Component* compo in self.components)
+    // The components of the file are not edits, the file itself becomes the starting point of the journal.
+    ModelJournal* journal = self.journal;
+    journal.isSuspended = YES;
+    
+    [self createComponents:graph];
+    
+    // Now that the file is completely read in, we can point the causal links to their parent and child objects.
+    [self connectCausalLinks];
+    
+    [self logImport:graph];
+    
+    // Display all of the imported components at once.
+    [self materializeViews];
+    
+    journal.isSuspended = NO;
+    [journal resetWithGraph:graph];
+}
+
+/// Creates a component for each record of a parsed Vensim mdl file, along with its view.
+/// The views are not displayed and the causal links are not connected to their parent and child.
+/// @param graph the parsed contents of the mdl file.
+-(void) createComponents:(ModelGraph*) graph
+{
+    // Read in the default and simulation control parameters.
+    self.defaultParams.params = graph.defaultParams;
+    [self.controlParams.params addObjectsFromArray:graph.controlParams];
+    
+    // Create the component for each record.
+    for(ComponentRecord* record in graph.records)
     {
-        if([compo isMemberOfClass:[Variable class]])
+        [self.idAllocator observeID:record.idNum];
+        switch(record.objectType)
         {
-            Variable* temp = (Variable*) compo;
-            [map addObjectsFromArray:[temp createVarMap]];
+            case CAUSAL_LINK:
+                [self insertComponent:[[CausalLink alloc] initWithRecord:record]];
+                break;
+                
+            case VARIABLE:
+                [self insertComponent:[[Variable alloc] initWithRecord:record]];
+                break;
+                
+            case LOOP:
+                [self insertComponent:[[Loop alloc] initWithRecord:record]];
+                break;
+                
+            default:
+                //Do nothing because we are only looking for the three types of components subclasses.
+                break;
         }
     }
-    return map;
+    
+    // The largest id will only exist if the the file being loaded had been saved previously from the app, and may be larger than any id left in the file if components were deleted.
+    // Otherwise if the file was originally created from Vensim, the largest id of the records is used.
+    [self.idAllocator observeID:graph.largestIDNum];
 }
 
-/// Constructs a list of output strings for every component.
-/// @return an array of output strings for all components.
--(NSMutableArray*) createComponentsExport
+/// Logs the import of a parsed Vensim mdl file in the mode set on the EventLogger.
+/// @param graph the parsed contents of the mdl file.
+-(void) logImport:(ModelGraph*) graph
 {
-    NSMutableArray* componentsExport = [[NSMutableArray alloc]init];
-    for(Component* compo in self.components)
+    if([EventLogger sharedEventLogger].importLogMode == IMPORT_LOG_SUMMARY)
     {
-        if([compo isMemberOfClass:[Loop class]])
+        [self logImportSummary:graph];
+    }
+    else
+    {
+        // Variables and loops are logged in file order, before the causal links that connect them.
+        for(Component* compo in self.components)
         {
-            [componentsExport addObject:[(Loop*)compo createLoopOutputString]];
+            if([compo isMemberOfClass:[Variable class]])
+            {
+                [(Variable*)compo logImport];
+            }
+            else if([compo isMemberOfClass:[Loop class]])
+            {
+                [(Loop*)compo logImport];
+            }
         }
-        else if([compo isMemberOfClass:[Variable class]])
+        for(CausalLink* link in self.causalLinks)
         {
-           [componentsExport addObject:[(Variable*)compo createVariableOutputString]];
+            [link logImport];
         }
-        else if([compo isMemberOfClass:[CausalLink class]])
+    }
+}
+
+/// Logs a single event describing an entire import instead of one event per component.
+/// The details contain the number of each type of component followed by a row of id,type,x,y,flags for every component, using the locations stored in the file.
+/// @param graph the parsed contents of the mdl file.
+-(void) logImportSummary:(ModelGraph*) graph
+{
+    int counts[3] = {0, 0, 0};
+    NSMutableString* table = [[NSMutableString alloc] init];
+    
+    for(ComponentRecord* record in graph.records)
+    {
+        int flags = 0;
+        switch(record.objectType)
         {
-            [componentsExport addObject:[(CausalLink*)compo createCausalLinkOutputString]];
+            case VARIABLE:
+                counts[0]++;
+                flags |= (record.symbol == BOXED_VAR) ? IMPORT_FLAG_SYMBOL : 0;
+                break;
+                
+            case CAUSAL_LINK:
+                counts[1]++;
+                flags |= (record.polarity == PLUS) ? IMPORT_FLAG_SYMBOL : 0;
+                flags |= (record.lineThickness != NORMAL) ? IMPORT_FLAG_BOLD : 0;
+                flags |= [record hasTimeDelay] ? IMPORT_FLAG_TIME_DELAY : 0;
+                flags |= (record.hasColor) ? IMPORT_FLAG_COLOR : 0;
+                break;
+                
+            case LOOP:
+                counts[2]++;
+                flags |= (record.symbol == CLOCKWISE) ? IMPORT_FLAG_SYMBOL : 0;
+                break;
+                
+            default:
+                break;
         }
+        [table appendFormat:IMPORT_TABLE_ROW, record.idNum, record.objectType, record.xcoord, record.ycoord, flags];
     }
     
-    return componentsExport;
+    NSMutableString* details = [[NSMutableString alloc] initWithFormat:IMPORT_COUNTS, counts[0], counts[1], counts[2]];
+    [details appendString:table];
+    [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID:IMPORTED_MODEL_SUMMARY
+                                                                andDetails:details]];
 }
 
-/// Adds a newly created object to the list of components existing in the model.
+/// Once the file has been read in completely we can finish processing the data.  The causal link parent and child objects upon import point to a string id of the parent and child, instead we would like the parent and child to point to the instance of those Variables.  Likewise, each variable would like to keep track of which CausalLinks are indegree and outdegree.
+-(void) connectCausalLinks
+{
+    // Iterate over all of the causal links in the model.
+    for(CausalLink* link in self.causalLinks)
+    {
+        // Ensuring the parent and child objects were previously of type NSNumber because they are holding the id.
+        if([[link parentObject] isKindOfClass:[NSNumber class]])
+        {
+            // Get the parent variable object.  Assign the CausalLink's parent to that object, and update the Varable's list of outdegree links with this CausalLink.
+            Variable* var = [self getVariable:[link parentObject]];
+            [link setParentObject:var];
+            [var addOutdegreeLink:link];
+        }
+        
+        if([[link childObject] isKindOfClass:[NSNumber class]])
+        {
+            // Get the child variable object.  Assign the CausalLink's child to that object, and update the Varable's list of indegree links with this CausalLink.
+            Variable* var = [self getVariable:[link childObject]];
+            [link setChildObject:var];
+            [var addIndegreeLink:link];
+        }
+        
+        // Now that the parent and child objects have been updated, we have access to the parent and child locations, so we can create the view that displays the CausalLink.
+        [link createView];
+    }
+}
+
+/// Adds the view of every component that is not yet displayed to the canvas, then redisplays once.
+/// CausalLinks are placed behind all other views so that their arcs do not cover the Variables.  Does nothing for a model that is not displayed.
+-(void) materializeViews
+{
+    UIView* parentView = self.canvas;
+    if(parentView == nil)
+    {
+        return;
+    }
+    
+    for(CausalLink* link in self.causalLinks)
+    {
+        if(link.view.superview == nil)
+        {
+            [parentView insertSubview:link.view atIndex:0];
+        }
+    }
+    for(Variable* var in self.variables)
+    {
+        if(var.view.superview == nil)
+        {
+            [parentView addSubview:var.view];
+        }
+    }
+    for(Loop* loop in self.loops)
+    {
+        if(loop.view.superview == nil)
+        {
+            [parentView addSubview:loop.view];
+        }
+    }
+    [parentView setNeedsDisplay];
+}
+
+/// Adds the view of a single component created by the user to the canvas and redisplays.
+/// CausalLinks are placed behind all other views so that their arcs do not cover the Variables.  Does nothing for a model that is not displayed.
+/// Within a transaction the view is added when the transaction is committed.
+/// @param obj the CausalLink, Variable or Loop to display.
+-(void) displayComponent:(id) obj
+{
+    UIView* parentView = self.canvas;
+    if(parentView == nil)
+    {
+        return;
+    }
+    if(self.transaction)
+    {
+        [self.transaction.displayed addObject:obj];
+        return;
+    }
+    
+    if([obj isMemberOfClass:[CausalLink class]])
+    {
+        [parentView insertSubview:[obj view] atIndex:0];
+    }
+    else
+    {
+        [parentView addSubview:[obj view]];
+    }
+    [parentView setNeedsDisplay];
+}
+
+/// Takes a snapshot of everything that is written to an exported mdl file, which can be exported on any thread while the model keeps being edited.
+/// The snapshot is reused until a component changes or the hashes or largest id of the model change.  Must be called on the main thread.
+/// @return the snapshot of the model.
+-(ModelSnapshot*) snapshot
+{
+    ModelSnapshot* snapshot = self.lastSnapshot;
+    if(!snapshot || snapshot.startingHash != self.startingHash || snapshot.largestIDNum != [self.idAllocator largestID])
+    {
+        snapshot = [[ModelSnapshot alloc] initWithModel:self];
+        self.lastSnapshot = snapshot;
+    }
+    return snapshot;
+}
+
+/// Adds a component created by the user to the model, records it in the journal and displays it.
+/// A component that does not have an id yet is given the next id of the model.
 /// @param obj an object that needs to be added to the model.  Will be either a CausalLink, Variable or a Loop.
 -(void) addComponent:(id) obj
 {
-    [self.components addObject:obj];
+    if([obj idNum] == 0)
+    {
+        [obj setIdNum:[self.idAllocator nextID]];
+    }
+    [self insertComponent:obj];
+    [self componentChanged:obj];
+    [self displayComponent:obj];
+    [self.transaction.addedIDs addIndex:[obj idNum]];
+    [self.history componentAdded:obj];
+}
+
+/// Adds a component that was removed from the model back to it, such as when an edit is undone.
+/// The component keeps the id of its record.  The Variables a CausalLink connects must already be part of the model.
+/// @param record the record of the component, created by createRecord.
+/// @return the CausalLink, Variable or Loop that was added, nil if it is a CausalLink whose Variables are not part of the model.
+-(id) addComponentWithRecord:(ComponentRecord*) record
+{
+    id obj = nil;
+    if(record.objectType == VARIABLE)
+    {
+        obj = [[Variable alloc] initWithRecord:record];
+    }
+    else if(record.objectType == LOOP)
+    {
+        obj = [[Loop alloc] initWithRecord:record];
+    }
+    else if(record.objectType == CAUSAL_LINK)
+    {
+        Variable* parent = [self getVariable:[NSNumber numberWithInt:record.parentID]];
+        Variable* child  = [self getVariable:[NSNumber numberWithInt:record.childID]];
+        if(parent == nil || child == nil)
+        {
+            return nil;
+        }
+        
+        CausalLink* link = [[CausalLink alloc] initWithRecord:record];
+        link.parentObject = parent;
+        link.childObject  = child;
+        [parent addOutdegreeLink:link];
+        [child addIndegreeLink:link];
+        [link createView];
+        obj = link;
+    }
+    
+    if(obj)
+    {
+        [self.idAllocator observeID:record.idNum];
+        [self addComponent:obj];
+    }
+    return obj;
+}
+
+/// Adds a component to the list of components existing in the model, and to the store of its type.  Does not display it.
+/// @param obj the CausalLink, Variable or Loop to add.
+-(void) insertComponent:(id) obj
+{
+    [obj setModel:self];
+    [self.components addComponent:obj];
+    [[self storeForComponent:obj] addComponent:obj];
+    self.lastSnapshot = nil;
+}
+
+/// Removes a component from the list of components existing in the model.  Does not remove its view.
+/// @param obj the CausalLink, Variable or Loop to remove.
+-(void) removeComponent:(id) obj
+{
+    if(obj == nil)
+    {
+        return;
+    }
+    [self.history willChangeComponent:obj];
+    [self.transaction.removedIDs addIndex:[obj idNum]];
+    [self.components removeComponent:obj];
+    [[self storeForComponent:obj] removeComponent:obj];
+    [self componentChanged:obj];
+    [obj setModel:nil];
+}
+
+/// Records that a component was added, removed or changed, so that the change is in the next snapshot and in the journal.
+/// @param obj the CausalLink, Variable or Loop that changed.
+-(void) componentChanged:(id) obj
+{
+    self.lastSnapshot = nil;
+    [self.journal componentChanged:[obj idNum]];
+    [self.transaction.changedIDs addIndex:[obj idNum]];
+}
+
+/// Gets the store that holds the components of the same type as a component.
+/// @param obj a CausalLink, Variable or Loop.
+/// @return the store for the type of the component, nil for any other object.
+-(ComponentStore*) storeForComponent:(id) obj
+{
+    if([obj isMemberOfClass:[Variable class]])
+    {
+        return self.variables;
+    }
+    else if([obj isMemberOfClass:[CausalLink class]])
+    {
+        return self.causalLinks;
+    }
+    else if([obj isMemberOfClass:[Loop class]])
+    {
+        return self.loops;
+    }
+    return nil;
 }
 
 /// Will add a new causalLink to the model given a parent and a child.  The link will be a straight line from the parent to the child.
@@ -129,7 +485,7 @@
 {
     // Create and add the new link.
     CausalLink* link = [[CausalLink alloc]initWithParent:parent andChild:child];
-    [[Model sharedModel] addComponent:link];
+    [self addComponent:link];
     
     // Update the parent and child with their newly added link.
     [parent addOutdegreeLink:link];
@@ -138,24 +494,20 @@
     return link.idNum;
 }
 
-/// Searches the list of components for a Variable component with a specified id.
+/// Looks up the Variable component with a specified id.
 /// @param idNumber the id number of the Variable that is being searched for.
-/// @return a pointer to a variable object with an id of idNumber.
+/// @return a pointer to a variable object with an id of idNumber, nil if the id does not belong to a Variable.
 -(Variable*) getVariable:(NSNumber*) idNumber
 {
-    Variable* obj = nil;
+    return (Variable*)[self.variables componentWithID:[idNumber intValue]];
+}
 
-    for(Component* compo in self.components)
-    {
-        if([compo isMemberOfClass:[Variable class]])
-        {
-            if([compo idNum] == idNumber.integerValue)
-            {
-                obj = (Variable*) compo;
-            }
-        }
-    }
-    return obj;
+/// Looks up the component with a specified id.
+/// @param idNum the id number of the component that is being searched for.
+/// @return a pointer to the Variable, CausalLink, or Loop with an id of idNum, nil if none exists.
+-(Component*) getComponent:(int) idNum
+{
+    return [self.components componentWithID:idNum];
 }
 
 /// Searches the list of components for a Variable component that contains the provided point.
@@ -165,41 +517,30 @@
 {
     Variable* obj = nil;
     
-    for(Component* compo in self.components)
+    for(Variable* temp in self.variables)
     {
-        if([compo isMemberOfClass:[Variable class]])
+        // Check to see if the point is in the frame.
+        CGPoint locInFrame = CGPointMake(point.x - temp.view.frame.origin.x,
+                                         point.y - temp.view.frame.origin.y);
+        if((locInFrame.x > 0 && locInFrame.x <= temp.view.frame.size.width) &&
+           (locInFrame.y > 0 && locInFrame.y <= temp.view.frame.size.height))
         {
-                Variable* temp = (Variable*) compo;
-         
-            // Check to see if the point is in the frame.
-            CGPoint locInFrame = CGPointMake(point.x - temp.view.frame.origin.x,
-                                             point.y - temp.view.frame.origin.y);
-            if((locInFrame.x > 0 && locInFrame.x <= temp.view.frame.size.width) &&
-               (locInFrame.y > 0 && locInFrame.y <= temp.view.frame.size.height))
-            {
-                obj = temp;
-            }
+            obj = temp;
         }
     }
     return obj;
 }
 
-/// Searches the list of components for a CausalLink component with a specified CausalLinkView.
+/// Deletes the CausalLink of a CausalLinkView.
 /// @param linkView the view associated with the CasualLink.
 /// @return the id numbder of the causal link that was deleted for logging purposes.
 -(int) deleteCausalLink:(id) linkView
 {
-    // Find the causal link
-    CausalLink* link = nil;
-    for(Component* compo in self.components)
+    // Find the causal link through the view, as long as it is still part of the model.
+    CausalLink* link = [(CausalLinkView*)linkView parent];
+    if(![self.causalLinks containsComponent:link])
     {
-        if([compo isMemberOfClass:[CausalLink class]])
-        {
-            if([(CausalLink*)compo view] == linkView)
-            {
-                link = (CausalLink*)compo;
-            }
-        }
+        link = nil;
     }
     
     // Remove indegree and out degree link for the corresponding variables.
@@ -208,117 +549,188 @@
     
     // Remove the CausalLink from the model.
     int idNum = link.idNum;
-    [self.components removeObject:link];
-    [linkView removeFromSuperview];
+    [self removeComponent:link];
+    [self removeView:linkView];
     
     return idNum;
 }
 
-/// Searched the list of components for a Loop component with a specified LoopView.
+/// Deletes the Loop of a LoopView.
 /// @param loopView the view associated with the Loop.
 /// @return the id numbder of the loop that was deleted for logging purposes.
 -(int) deleteLoop:(id) loopView
 {
-    // Find the feedback loop
-    Loop* loop = nil;
-    for(Component* compo in self.components)
+    // Find the feedback loop through the view, as long as it is still part of the model.
+    Loop* loop = [(LoopView*)loopView parent];
+    if(![self.loops containsComponent:loop])
     {
-        if([compo isMemberOfClass:[Loop class]])
-        {
-            if([(Loop*)compo view] == loopView)
-            {
-                loop = (Loop*)compo;
-            }
-        }
+        loop = nil;
     }
     
     // Remove the Loop from the model.
     int idNum = loop.idNum;
-    [self.components removeObject:loop];
-    [loopView removeFromSuperview];
+    [self removeComponent:loop];
+    [self removeView:loopView];
     
     return idNum;
 }
 
-/// Searched the list of components for a Variable component with a specified VariableView.
+/// Deletes the Variable of a VariableView along with every CausalLink touching it.
+/// The views are removed in a single pass once every link has been removed.
 /// @param variableView the view associated with the Variable.
 /// @return the id numbder of the variable that was deleted for logging purposes.
 -(int) deleteVariable:(id) variableView
 {
-    // Find the variable
-    Variable* var = nil;
-    for(Component* compo in self.components)
+    // Find the variable through the view, as long as it is still part of the model.
+    Variable* var = [(VariableView*)variableView parent];
+    if(![self.variables containsComponent:var])
     {
-        if([compo isMemberOfClass:[Variable class]])
-        {
-            if([(Variable*)compo view] == variableView)
-            {
-                var = (Variable*)compo;
-            }
-        }
+        var = nil;
     }
     
     // Will log how many links were deleted and what the links were.
     int count = var.indegreeLinks.count + var.outdegreeLinks.count;
     NSMutableString* details = [[NSMutableString alloc] initWithFormat: NUMBER_DELETED, count];
     
+    int idNum = var.idNum;
+    [self beginTransaction];
+    [self removeVariable:var withDetails:details];
+    if(var == nil)
+    {
+        [self removeView:variableView];
+    }
+    [self commitTransaction:nil];
+    
+    // Log the details about the deleted links if there are links to delete.
+    if(count != 0)
+    {
+        [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID:REMOVED_LINKS
+                                                                   andObjectID:idNum
+                                                                    andDetails:details]];
+    }
+    
+    return idNum;
+}
+
+/// Removes a Variable and every CausalLink touching it from the model, along with their views.
+/// @param var the Variable to remove.
+/// @param details the description of each removed link is appended to it.  nil when the links are not described, such as when an edit is undone.
+-(void) removeVariable:(Variable*) var withDetails:(NSMutableString*) details
+{
     // Remove indegree links from the model.
     for(id link in var.indegreeLinks)
     {
         CausalLink* l = link;
-        Variable* parent = l.parentObject;
-        Variable* child  = l.childObject;
-        [details appendFormat:@"id:%d ", l.idNum];
-        [details appendFormat:PARENT_CHILD, parent.view.name, parent.idNum, child.view.name, child.idNum];
+        if(details)
+        {
+            Variable* parent = l.parentObject;
+            Variable* child  = l.childObject;
+            [details appendFormat:@"id:%d ", l.idNum];
+            [details appendFormat:PARENT_CHILD, parent.view.name, parent.idNum, child.view.name, child.idNum];
+        }
         
         // Remove the link from the parent object so it does not exist in the export.
         [l.parentObject removeOutdgreeLink:l];
-        [self.components removeObject:link];
-        [l.view removeFromSuperview];
+        [self removeComponent:link];
+        [self removeView:l.view];
     }
     
     // Remove outdegree links from the model.
     for(id link in var.outdegreeLinks)
     {
         CausalLink* l = link;
-        Variable* parent = l.parentObject;
-        Variable* child  = l.childObject;
-        [details appendFormat:@"id:%d ", l.idNum];
-        [details appendFormat:PARENT_CHILD, parent.view.name, parent.idNum, child.view.name, child.idNum];
+        if(details)
+        {
+            Variable* parent = l.parentObject;
+            Variable* child  = l.childObject;
+            [details appendFormat:@"id:%d ", l.idNum];
+            [details appendFormat:PARENT_CHILD, parent.view.name, parent.idNum, child.view.name, child.idNum];
+        }
         
         // Remove the link from the child object so it does not exist in the export.
         [l.childObject removeIndgreeLink:l];
-        [self.components removeObject:link];
-        [l.view removeFromSuperview];
+        [self removeComponent:link];
+        [self removeView:l.view];
     }
     
-    // Log the details about the deleted links if there are links to delete.
-    if(count != 0)
+    // Remove the Variable from the model.
+    [self removeComponent:var];
+    [self removeView:var.view];
+}
+
+/// Removes the view of a deleted component from the canvas.  Within a transaction the view is removed when the transaction is committed.
+/// @param view the view of the deleted component.
+-(void) removeView:(UIView*) view
+{
+    if(view == nil)
     {
-        [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID:REMOVED_LINKS
-                                                                   andObjectID:var.idNum
-                                                                    andDetails:details]];
+        return;
     }
-    
-    // Remove the Variable from the model.
-    int idNum = var.idNum;
-    [self.components removeObject:var];
-    [variableView removeFromSuperview];
-    
-    return idNum;
+    if(self.transaction)
+    {
+        [self.transaction.removedViews addObject:view];
+        return;
+    }
+    [view removeFromSuperview];
 }
 
-/// Gets the root view controller view.
-/// @return the currently displayed view controller view from the app delegate.
--(UIView*) getViewControllerView
+//================================================================================================================================
+// Transactions.
+//================================================================================================================================
+
+/// Starts collecting edits, so that many components can be changed with a single update of the canvas and a single logged event.
+/// Transactions can be nested.  Only the outermost commitTransaction: applies the transaction.
+-(void) beginTransaction
 {
-    AppDelegate* app = [UIApplication sharedApplication].delegate;
-    MFSideMenuContainerViewController *parent = (MFSideMenuContainerViewController*) app.window.rootViewController;
+    if(!self.transaction)
+    {
+        self.transaction = [[ModelTransaction alloc] init];
+    }
+    self.transaction.depth++;
+}
+
+/// Ends a transaction started with beginTransaction.
+/// The views of the added and removed components are updated in one pass without animations, the canvas is redisplayed once, and one event describing the transaction is logged.
+/// @param action what the transaction did, logged with the ids it touched.  nil if the caller logs its own event.  Ignored for nested transactions.
+-(void) commitTransaction:(NSString*) action
+{
+    ModelTransaction* transaction = self.transaction;
+    if(!transaction || --transaction.depth > 0)
+    {
+        return;
+    }
+    self.transaction = nil;
     
-    UINavigationController *navigationController = parent.centerViewController;
+    UIView* parentView = self.canvas;
+    [CATransaction begin];
+    [CATransaction setDisableActions:YES];
+    for(UIView* view in transaction.removedViews)
+    {
+        [view removeFromSuperview];
+    }
+    for(id obj in transaction.displayed)
+    {
+        // A component added and removed again in the same transaction is not displayed.
+        if([[self storeForComponent:obj] containsComponent:obj])
+        {
+            if([obj isMemberOfClass:[CausalLink class]])
+            {
+                [parentView insertSubview:[obj view] atIndex:0];
+            }
+            else
+            {
+                [parentView addSubview:[obj view]];
+            }
+        }
+    }
+    [CATransaction commit];
+    [parentView setNeedsDisplay];
     
-
-    return navigationController.visibleViewController.view;
+    if(action && (transaction.addedIDs.count + transaction.changedIDs.count + transaction.removedIDs.count) > 0)
+    {
+        [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID:TRANSACTION_COMMITTED
+                                                                    andDetails:[transaction detailsForAction:action]]];
+    }
 }
 
 /// Gets the view controller.
@@ -333,23 +745,13 @@
     return (UIViewController*) navigationController.visibleViewController;
 }
 
-/// Searches the list of components for a Variable component with a specified VariableView and will move the attached CausalLinks.
+/// Moves the CausalLinks attached to the Variable of a VariableView.
+/// Called for every touch while a variable is dragged, so the variable is found through the view instead of searching the model.
 /// @param variableView the view associated with the Variable.
 -(void) moveVariable:(id) variableView
 {
     VariableView* varView = variableView;
-    // Find the variable
-    Variable* var = nil;
-    for(Component* compo in self.components)
-    {
-        if([compo isMemberOfClass:[Variable class]])
-        {
-            if([(Variable*)compo view] == variableView)
-            {
-                var = (Variable*)compo;
-            }
-        }
-    }
+    Variable* var = varView.parent;
     
     // Move indegree links touching the Variable.
     for(id link in var.indegreeLinks)
@@ -370,14 +772,9 @@
 /// @param location the point in the coordinate space user to determine if a variable contains that point.
 -(void) setVariableColor:(CGPoint) location
 {
-    Variable* var = nil;
-    for(Component* compo in self.components)
+    for(Variable* var in self.variables)
     {
-        if([compo isMemberOfClass:[Variable class]])
-        {
-            var = (Variable*)compo;
-            [var.view setBoxColorBasedOnPoint:location];
-        }
+        [var.view setBoxColorBasedOnPoint:location];
     }
 }
 
@@ -393,21 +790,8 @@
     // Iterate over all of the components in the model.
     for(Component* compo in self.components)
     {
-        CGRect rect;
-        
-        // Get the frame of the component based on its type.
-        if([compo isMemberOfClass:[Variable class]])
-        {
-            rect = [(Variable*)compo view].frame;
-        }
-        else if([compo isMemberOfClass:[CausalLink class]])
-        {
-            rect = [(CausalLink*)compo view].frame;
-        }
-        else if([compo isMemberOfClass:[Loop class]])
-        {
-            rect = [(Loop*)compo view].frame;
-        }
+        // Every type of component has a view.
+        CGRect rect = [[(id)compo view] frame];
         
         // Check if the component's frame origin is less than the current origin.
         if(rect.origin.x < origin.x)
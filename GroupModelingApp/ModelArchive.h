@@ -0,0 +1,86 @@
+//
+//  ModelArchive.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "ComponentRecord.h"
+#import "ModelGraph.h"
+
+/// A string stored in the string table of an archive.
+struct ArchiveString
+{
+    uint32_t offset; // The offset of the UTF-8 bytes from the start of the string table.
+    uint32_t length; // The number of UTF-8 bytes.
+};
+
+/// The start of every archive.  Followed by the control parameters, the records, and finally the string table.
+struct ArchiveHeader
+{
+    uint32_t             magic;             // Always MODEL_ARCHIVE_MAGIC.
+    uint32_t             version;           // The MODEL_ARCHIVE_VERSION the archive was written with.
+    uint32_t             recordSize;        // sizeof(struct ArchiveRecord) when the archive was written.
+    uint32_t             recordCount;       // The number of records.
+    uint32_t             controlParamCount; // The number of control parameter lines.
+    int32_t              largestIDNum;      // The largest id handed out in the model.
+    struct ArchiveString defaultParams;     // The default parameters of the sketch.
+    uint32_t             stringTableOffset; // The offset of the string table from the start of the archive.
+    uint32_t             stringTableLength; // The number of bytes in the string table.
+};
+
+/// The flags of an ArchiveRecord.
+enum ArchiveRecordFlags
+{
+    ARCHIVE_HAS_COLOR = 1, // The red, green, and blue values of the record are used.
+    ARCHIVE_HAS_ARC   = 2  // The control and vertex points of the record are used.
+};
+
+/// A fixed width ComponentRecord.  Every field is 4 bytes wide so the records can be read in place without any padding.
+struct ArchiveRecord
+{
+    int32_t              objectType;
+    int32_t              idNum;
+    struct ArchiveString name;
+    int32_t              xcoord;
+    int32_t              ycoord;
+    int32_t              symbol;
+    int32_t              textPosition;
+    int32_t              parentID;
+    int32_t              childID;
+    int32_t              polarity;
+    int32_t              lineThickness;
+    int32_t              delay;
+    uint8_t              red;
+    uint8_t              green;
+    uint8_t              blue;
+    uint8_t              flags;
+    float                controlX;
+    float                controlY;
+    float                vertexX;
+    float                vertexY;
+};
+
+/// The binary format the app saves models in locally, and that the ModelCache and ModelJournal store their snapshots in.
+/// An archive is a header, the control parameters, an array of fixed width records, and a table holding every string, so it can be read straight out of a memory mapped file without being parsed.
+/// Unlike a Vensim mdl file, the records of the causal links also hold their control and vertex points, so the arcs do not need to be calculated again when they are loaded.
+/// The mdl file is still the format used to exchange models with Vensim and Dropbox.
+@interface ModelArchive : NSObject
+
+/// The contents of the archive.  Usually mapped from a file.
+@property NSData* data;
+
+-(id)initWithData:(NSData*)data;
+-(id)initWithContentsOfFile:(NSString*)path;
+-(NSUInteger) recordCount;
+-(const struct ArchiveRecord*) recordAtIndex:(NSUInteger)index;
+-(NSString*) stringFor:(struct ArchiveString)string;
+-(ModelGraph*) graph;
++(bool) isArchive:(NSData*)data;
++(NSData*) dataFromGraph:(ModelGraph*)graph;
++(void) appendRecord:(ComponentRecord*)record toData:(NSMutableData*)data;
++(ComponentRecord*) recordFromBytes:(const uint8_t*)bytes length:(NSUInteger)length;
+
+@end
@@ -0,0 +1,295 @@
+//
+//  ModelArchive.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "Constants.h"
+#import "ModelArchive.h"
+
+/// Adds a string to the string table of an archive being written.
+/// @param table the string table.
+/// @param string the string to add.
+/// @return the location of the string within the table.
+static struct ArchiveString appendArchiveString(NSMutableData* table, NSString* string)
+{
+    NSData* utf8 = [string dataUsingEncoding:NSUTF8StringEncoding];
+    struct ArchiveString location = { (uint32_t)table.length, (uint32_t)utf8.length };
+    [table appendData:utf8];
+    return location;
+}
+
+/// Converts a ComponentRecord to its fixed width form.
+/// @param record the record to convert.
+/// @param name the location of the name of the record in the string table.
+/// @return the fixed width record.
+static struct ArchiveRecord archiveRecordFromRecord(ComponentRecord* record, struct ArchiveString name)
+{
+    struct ArchiveRecord archived;
+    memset(&archived, 0, sizeof(archived));
+    archived.objectType    = record.objectType;
+    archived.idNum         = record.idNum;
+    archived.name          = name;
+    archived.xcoord        = record.xcoord;
+    archived.ycoord        = record.ycoord;
+    archived.symbol        = record.symbol;
+    archived.textPosition  = record.textPosition;
+    archived.parentID      = record.parentID;
+    archived.childID       = record.childID;
+    archived.polarity      = record.polarity;
+    archived.lineThickness = record.lineThickness;
+    archived.delay         = record.delay;
+    archived.red           = record.red;
+    archived.green         = record.green;
+    archived.blue          = record.blue;
+    archived.flags         = ((record.hasColor) ? ARCHIVE_HAS_COLOR : 0) | ((record.hasArc) ? ARCHIVE_HAS_ARC : 0);
+    archived.controlX      = record.controlX;
+    archived.controlY      = record.controlY;
+    archived.vertexX       = record.vertexX;
+    archived.vertexY       = record.vertexY;
+    return archived;
+}
+
+/// Converts a fixed width record back to a ComponentRecord.
+/// @param archived the fixed width record.
+/// @param name the name of the record, already read from the string table.
+/// @return the ComponentRecord.
+static ComponentRecord* recordFromArchiveRecord(const struct ArchiveRecord* archived, NSString* name)
+{
+    ComponentRecord* record = [[ComponentRecord alloc] init];
+    record.objectType    = archived->objectType;
+    record.idNum         = archived->idNum;
+    record.name          = name;
+    record.xcoord        = archived->xcoord;
+    record.ycoord        = archived->ycoord;
+    record.symbol        = archived->symbol;
+    record.textPosition  = archived->textPosition;
+    record.parentID      = archived->parentID;
+    record.childID       = archived->childID;
+    record.polarity      = archived->polarity;
+    record.lineThickness = archived->lineThickness;
+    record.delay         = archived->delay;
+    record.hasColor      = (archived->flags & ARCHIVE_HAS_COLOR) != 0;
+    record.red           = archived->red;
+    record.green         = archived->green;
+    record.blue          = archived->blue;
+    record.hasArc        = (archived->flags & ARCHIVE_HAS_ARC) != 0;
+    record.controlX      = archived->controlX;
+    record.controlY      = archived->controlY;
+    record.vertexX       = archived->vertexX;
+    record.vertexY       = archived->vertexY;
+    return record;
+}
+
+@implementation ModelArchive
+
+@synthesize data = _data;
+
+/// Initializes a ModelArchive over the contents of an archive.
+/// Only the header is checked here.  The records and strings are read in place when they are asked for.
+/// @param data the contents of the archive.
+/// @return a pointer to the newly created ModelArchive, nil if the data is not a complete archive of this version.
+-(id)initWithData:(NSData*)data
+{
+    if(![ModelArchive isArchive:data])
+    {
+        return nil;
+    }
+    
+    const struct ArchiveHeader* header = [data bytes];
+    unsigned long long recordsEnd = sizeof(struct ArchiveHeader) +
+                                    (unsigned long long)header->controlParamCount * sizeof(struct ArchiveString) +
+                                    (unsigned long long)header->recordCount * sizeof(struct ArchiveRecord);
+    if(header->version != MODEL_ARCHIVE_VERSION || header->recordSize != sizeof(struct ArchiveRecord) ||
+       header->stringTableOffset < recordsEnd ||
+       (unsigned long long)header->stringTableOffset + header->stringTableLength > data.length)
+    {
+        return nil;
+    }
+    
+    self = [super init];
+    if(self)
+    {
+        self.data = data;
+    }
+    return self;
+}
+
+/// Initializes a ModelArchive by memory mapping a file, so only the pages that are read are loaded.
+/// @param path the location of the archive.
+/// @return a pointer to the newly created ModelArchive, nil if the file could not be read or is not an archive.
+-(id)initWithContentsOfFile:(NSString*)path
+{
+    return [self initWithData:[NSData dataWithContentsOfFile:path options:NSDataReadingMappedAlways error:nil]];
+}
+
+/// Gets the header of the archive.
+/// @return the header at the start of the data.
+-(const struct ArchiveHeader*) header
+{
+    return [self.data bytes];
+}
+
+/// Gets the number of records in the archive.
+/// @return the number of records.
+-(NSUInteger) recordCount
+{
+    return [self header]->recordCount;
+}
+
+/// Gets a record in place.
+/// @param index the index of the record, which must be less than recordCount.
+/// @return a pointer to the record within the data.
+-(const struct ArchiveRecord*) recordAtIndex:(NSUInteger)index
+{
+    const struct ArchiveHeader* header = [self header];
+    const uint8_t* records = (const uint8_t*)header + sizeof(struct ArchiveHeader) + header->controlParamCount * sizeof(struct ArchiveString);
+    return (const struct ArchiveRecord*)records + index;
+}
+
+/// Reads a string from the string table.
+/// @param string the location of the string.
+/// @return the string, an empty string if the location is outside of the table.
+-(NSString*) stringFor:(struct ArchiveString)string
+{
+    const struct ArchiveHeader* header = [self header];
+    if((unsigned long long)string.offset + string.length > header->stringTableLength)
+    {
+        return @"";
+    }
+    NSString* value = [[NSString alloc] initWithBytes:(const uint8_t*)header + header->stringTableOffset + string.offset
+                                               length:string.length
+                                             encoding:NSUTF8StringEncoding];
+    return (value) ? value : @"";
+}
+
+/// Creates a ModelGraph holding every record of the archive, which the Model can load the same way as a parsed mdl file.
+/// @return the graph of the archive.
+-(ModelGraph*) graph
+{
+    const struct ArchiveHeader* header = [self header];
+    ModelGraph* graph = [[ModelGraph alloc] init];
+    graph.largestIDNum  = header->largestIDNum;
+    graph.defaultParams = [self stringFor:header->defaultParams];
+    
+    const struct ArchiveString* params = (const struct ArchiveString*)(header + 1);
+    for(uint32_t i = 0; i < header->controlParamCount; ++i)
+    {
+        [graph.controlParams addObject:[self stringFor:params[i]]];
+    }
+    
+    for(NSUInteger i = 0; i < header->recordCount; ++i)
+    {
+        const struct ArchiveRecord* archived = [self recordAtIndex:i];
+        [graph addRecord:recordFromArchiveRecord(archived, [self stringFor:archived->name])];
+    }
+    return graph;
+}
+
+/// Determines whether data starts like an archive.  Used to tell an archive from a Vensim mdl file.
+/// @param data the contents of a file.
+/// @return true if the data is long enough to hold a header and starts with MODEL_ARCHIVE_MAGIC.
++(bool) isArchive:(NSData*)data
+{
+    if(data.length < sizeof(struct ArchiveHeader))
+    {
+        return false;
+    }
+    return ((const struct ArchiveHeader*)[data bytes])->magic == MODEL_ARCHIVE_MAGIC;
+}
+
+/// Writes an archive.
+/// @param records the ComponentRecord of every component.
+/// @param controlParams the lines of the simulation control parameters.
+/// @param defaultParams the default parameters of the sketch.
+/// @param largestIDNum the largest id handed out in the model.
+/// @return the contents of the archive.
++(NSData*) dataFromRecords:(NSArray*)records
+             controlParams:(NSArray*)controlParams
+             defaultParams:(NSString*)defaultParams
+              largestIDNum:(int)largestIDNum
+{
+    NSMutableData* table = [[NSMutableData alloc] init];
+    
+    struct ArchiveHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic             = MODEL_ARCHIVE_MAGIC;
+    header.version           = MODEL_ARCHIVE_VERSION;
+    header.recordSize        = sizeof(struct ArchiveRecord);
+    header.recordCount       = (uint32_t)records.count;
+    header.controlParamCount = (uint32_t)controlParams.count;
+    header.largestIDNum      = largestIDNum;
+    header.defaultParams     = appendArchiveString(table, (defaultParams) ? defaultParams : @"");
+    header.stringTableOffset = (uint32_t)(sizeof(header) + controlParams.count * sizeof(struct ArchiveString) +
+                                          records.count * sizeof(struct ArchiveRecord));
+    
+    NSMutableData* data = [[NSMutableData alloc] initWithCapacity:header.stringTableOffset];
+    [data appendBytes:&header length:sizeof(header)];
+    
+    for(NSString* param in controlParams)
+    {
+        struct ArchiveString location = appendArchiveString(table, param);
+        [data appendBytes:&location length:sizeof(location)];
+    }
+    
+    for(ComponentRecord* record in records)
+    {
+        struct ArchiveRecord archived = archiveRecordFromRecord(record, appendArchiveString(table, record.name));
+        [data appendBytes:&archived length:sizeof(archived)];
+    }
+    
+    // The length of the string table is only known once every string has been added.
+    ((struct ArchiveHeader*)[data mutableBytes])->stringTableLength = (uint32_t)table.length;
+    [data appendData:table];
+    return data;
+}
+
+/// Writes an archive of a parsed model.
+/// @param graph the graph of the model.
+/// @return the contents of the archive.
++(NSData*) dataFromGraph:(ModelGraph*)graph
+{
+    return [ModelArchive dataFromRecords:graph.records
+                           controlParams:graph.controlParams
+                           defaultParams:graph.defaultParams
+                            largestIDNum:graph.largestIDNum];
+}
+
+/// Appends a single record outside of an archive, as used by the entries of the ModelJournal.
+/// The fixed width record is followed by its name, so the name is at offset 0 of a string table that starts right after the record.
+/// @param record the record to append.
+/// @param data the data to append to.
++(void) appendRecord:(ComponentRecord*)record toData:(NSMutableData*)data
+{
+    NSData* name = [record.name dataUsingEncoding:NSUTF8StringEncoding];
+    struct ArchiveString location = { 0, (uint32_t)name.length };
+    struct ArchiveRecord archived = archiveRecordFromRecord(record, location);
+    [data appendBytes:&archived length:sizeof(archived)];
+    [data appendData:name];
+}
+
+/// Reads a single record written by appendRecord:toData:.
+/// @param bytes the start of the record.
+/// @param length the number of bytes holding the record and its name.
+/// @return the record, nil if the bytes do not hold exactly one record.
++(ComponentRecord*) recordFromBytes:(const uint8_t*)bytes length:(NSUInteger)length
+{
+    if(length < sizeof(struct ArchiveRecord))
+    {
+        return nil;
+    }
+    
+    struct ArchiveRecord archived;
+    memcpy(&archived, bytes, sizeof(archived));
+    if(archived.name.offset != 0 || archived.name.length != length - sizeof(archived))
+    {
+        return nil;
+    }
+    
+    NSString* name = [[NSString alloc] initWithBytes:bytes + sizeof(archived) length:archived.name.length encoding:NSUTF8StringEncoding];
+    return recordFromArchiveRecord(&archived, (name) ? name : @"");
+}
+
+@end
@@ -0,0 +1,29 @@
+//
+//  ModelBenchmark.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/// Times each phase of importing and exporting a Vensim mdl file so that builds can be compared.
+/// The phases are parsing the file, constructing the components, connecting the causal links, taking a snapshot of the model, streaming it to a file while hashing it, writing and reading the archive, and finding its feedback loops.
+/// Run from a debug build by launching the application with the arguments -benchmarkFile <path> and optionally -benchmarkIterations <count>.
+/// The results are written as JSON to benchmark.json in the documents directory and printed to the console.
+/// @note runs on a Model of its own that is not displayed, so the model on screen is left alone.  The components still create their views, so it must be run on the main thread.
+@interface ModelBenchmark : NSObject
+
+/// The location of the mdl file to benchmark.  PythonScripts/generateModel.py creates files of any size.
+@property NSString* path;
+
+/// How many times each phase is run.
+@property int iterations;
+
++(void) runFromLaunchArguments;
+-(id)initWithPath:(NSString*)path iterations:(int)iterations;
+-(NSDictionary*) run;
+-(NSString*) writeResults:(NSDictionary*)results;
+
+@end
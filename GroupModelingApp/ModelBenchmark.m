@@ -0,0 +1,203 @@
+//
+//  ModelBenchmark.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "CausalLink.h"
+#import "Constants.h"
+#import "FileIO.h"
+#import "Loop.h"
+#import "LoopFinder.h"
+#import "Model.h"
+#import "ModelArchive.h"
+#import "ModelBenchmark.h"
+#import "ModelParser.h"
+#import "Variable.h"
+
+/// Creates the statistics of a single phase.
+/// @param times the time in milliseconds of each iteration of the phase.
+/// @return a dictionary with the min, median, mean, and max times.
+static NSDictionary* phaseStatistics(NSArray* times)
+{
+    NSArray* sorted = [times sortedArrayUsingSelector:@selector(compare:)];
+    double total = 0;
+    for(NSNumber* time in sorted)
+    {
+        total += [time doubleValue];
+    }
+    return [NSDictionary dictionaryWithObjectsAndKeys:
+            [sorted objectAtIndex:0],                   BENCHMARK_MIN,
+            [sorted objectAtIndex:sorted.count / 2],    BENCHMARK_MEDIAN,
+            [NSNumber numberWithDouble:total / sorted.count], BENCHMARK_MEAN,
+            [sorted lastObject],                        BENCHMARK_MAX,
+            nil];
+}
+
+@implementation ModelBenchmark
+
+@synthesize path       = _path;
+@synthesize iterations = _iterations;
+
+/// Runs the benchmark if the application was launched with -benchmarkFile <path>.
+/// Launch arguments of the form -key value are read through the standard user defaults.
++(void) runFromLaunchArguments
+{
+    NSUserDefaults* defaults = [NSUserDefaults standardUserDefaults];
+    NSString* path = [defaults stringForKey:BENCHMARK_FILE_ARG];
+    if(!path)
+    {
+        return;
+    }
+    
+    int iterations = (int)[defaults integerForKey:BENCHMARK_ITERATIONS_ARG];
+    ModelBenchmark* benchmark = [[ModelBenchmark alloc] initWithPath:path
+                                                          iterations:(iterations > 0) ? iterations : BENCHMARK_DEFAULT_ITERATIONS];
+    NSDictionary* results = [benchmark run];
+    if(results)
+    {
+        [benchmark writeResults:results];
+    }
+}
+
+/// Initializes the ModelBenchmark.
+/// @param path the location of the mdl file to benchmark.
+/// @param iterations how many times each phase is run.
+/// @return a pointer to the newly created ModelBenchmark.
+-(id)initWithPath:(NSString*)path iterations:(int)iterations
+{
+    self = [super init];
+    if(self)
+    {
+        self.path       = path;
+        self.iterations = iterations;
+    }
+    return self;
+}
+
+/// Runs every phase of the benchmark.  Must be called on the main thread since the components create views.
+/// @return a dictionary of the file being benchmarked and the timing statistics of each phase.  nil if the file could not be read.
+-(NSDictionary*) run
+{
+    NSData* data = [NSData dataWithContentsOfFile:self.path options:NSDataReadingMappedAlways error:nil];
+    if(!data)
+    {
+        NSLog(@"Unable to read benchmark file %@", self.path);
+        return nil;
+    }
+    
+    NSArray* phases = [NSArray arrayWithObjects:BENCHMARK_PARSE, BENCHMARK_CONSTRUCT, BENCHMARK_CONNECT, BENCHMARK_SNAPSHOT,
+                                                BENCHMARK_EXPORT, BENCHMARK_ARCHIVE_WRITE, BENCHMARK_ARCHIVE_READ, BENCHMARK_FIND_LOOPS, nil];
+    NSMutableDictionary* times = [[NSMutableDictionary alloc] init];
+    for(NSString* phase in phases)
+    {
+        [times setObject:[[NSMutableArray alloc] init] forKey:phase];
+    }
+    
+    NSString* outputPath  = [NSTemporaryDirectory() stringByAppendingPathComponent:BENCHMARK_OUTPUT_MDL];
+    NSString* archivePath = [NSTemporaryDirectory() stringByAppendingPathComponent:BENCHMARK_OUTPUT_ARCHIVE];
+    ModelGraph* graph = nil;
+    
+    // The iterations run on a model of their own, so the model on screen is left alone.
+    Model* model = [[Model alloc] init];
+    
+    for(int i = 0; i < self.iterations; ++i)
+    {
+        [model clearModel];
+        
+        @autoreleasepool
+        {
+            CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+            graph = [[[ModelParser alloc] init] parseData:data];
+            [self recordPhase:BENCHMARK_PARSE from:start into:times];
+            
+            start = CFAbsoluteTimeGetCurrent();
+            [model createComponents:graph];
+            [self recordPhase:BENCHMARK_CONSTRUCT from:start into:times];
+            
+            start = CFAbsoluteTimeGetCurrent();
+            [model connectCausalLinks];
+            [self recordPhase:BENCHMARK_CONNECT from:start into:times];
+            
+            // The model was just built, so the snapshot renders every component the way the first save of an opened file does.
+            start = CFAbsoluteTimeGetCurrent();
+            ModelSnapshot* snapshot = [model snapshot];
+            [self recordPhase:BENCHMARK_SNAPSHOT from:start into:times];
+            
+            start = CFAbsoluteTimeGetCurrent();
+            [[FileIO sharedFileIO] exportSnapshot:snapshot toPath:outputPath];
+            [self recordPhase:BENCHMARK_EXPORT from:start into:times];
+            
+            // The same archive the edit journal writes as its snapshot when a file is opened.
+            start = CFAbsoluteTimeGetCurrent();
+            [[ModelArchive dataFromGraph:graph] writeToFile:archivePath atomically:NO];
+            [self recordPhase:BENCHMARK_ARCHIVE_WRITE from:start into:times];
+            
+            start = CFAbsoluteTimeGetCurrent();
+            [[[ModelArchive alloc] initWithContentsOfFile:archivePath] graph];
+            [self recordPhase:BENCHMARK_ARCHIVE_READ from:start into:times];
+            
+            start = CFAbsoluteTimeGetCurrent();
+            [[[LoopFinder alloc] initWithModel:model] findLoops:nil];
+            [self recordPhase:BENCHMARK_FIND_LOOPS from:start into:times];
+        }
+    }
+    
+    // Count the components of the last iteration before clearing the model.
+    int variables = (int)model.variables.count;
+    int links     = (int)model.causalLinks.count;
+    int loops     = (int)model.loops.count;
+    [model clearModel];
+    [[NSFileManager defaultManager] removeItemAtPath:outputPath error:nil];
+    [[NSFileManager defaultManager] removeItemAtPath:archivePath error:nil];
+    
+    NSMutableDictionary* phaseResults = [[NSMutableDictionary alloc] init];
+    for(NSString* phase in phases)
+    {
+        [phaseResults setObject:phaseStatistics([times objectForKey:phase]) forKey:phase];
+    }
+    
+    return [NSDictionary dictionaryWithObjectsAndKeys:
+            [self.path lastPathComponent],                                                                 BENCHMARK_FILE,
+            [NSNumber numberWithUnsignedInteger:data.length],                                              BENCHMARK_BYTES,
+            [NSNumber numberWithInt:variables],                                                            BENCHMARK_VARIABLES,
+            [NSNumber numberWithInt:links],                                                                BENCHMARK_LINKS,
+            [NSNumber numberWithInt:loops],                                                                BENCHMARK_LOOPS,
+            [NSNumber numberWithInt:self.iterations],                                                      BENCHMARK_ITERATIONS,
+            [NSNumber numberWithUnsignedInteger:[[NSProcessInfo processInfo] activeProcessorCount]],       BENCHMARK_CORES,
+            [[UIDevice currentDevice] systemVersion],                                                      BENCHMARK_SYSTEM,
+            [[[NSBundle mainBundle] infoDictionary] objectForKey:(NSString*)kCFBundleVersionKey],         BENCHMARK_BUILD,
+            phaseResults,                                                                                  BENCHMARK_PHASES,
+            nil];
+}
+
+/// Records the time a phase took.
+/// @param phase the name of the phase.
+/// @param start when the phase started.
+/// @param times the times of every phase.
+-(void) recordPhase:(NSString*)phase from:(CFAbsoluteTime)start into:(NSMutableDictionary*)times
+{
+    double milliseconds = (CFAbsoluteTimeGetCurrent() - start) * 1000.0;
+    [[times objectForKey:phase] addObject:[NSNumber numberWithDouble:milliseconds]];
+}
+
+/// Writes the results of the benchmark as JSON to the documents directory and prints them to the console.
+/// @param results the results returned by run.
+/// @return the path of the results file, nil if it could not be written.
+-(NSString*) writeResults:(NSDictionary*)results
+{
+    NSData* json = [NSJSONSerialization dataWithJSONObject:results options:NSJSONWritingPrettyPrinted error:nil];
+    if(!json)
+    {
+        return nil;
+    }
+    NSLog(@"%@", [[NSString alloc] initWithData:json encoding:NSUTF8StringEncoding]);
+    
+    NSString* docsDir = [NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES) objectAtIndex:0];
+    NSString* path = [docsDir stringByAppendingPathComponent:BENCHMARK_RESULTS_FILE];
+    return ([json writeToFile:path atomically:YES]) ? path : nil;
+}
+
+@end
@@ -0,0 +1,33 @@
+//
+//  ModelCache.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "ModelGraph.h"
+
+/// An on-disk cache of parsed models keyed by the sha1 hash of the original mdl file.
+/// Reopening a file that has not changed loads a snapshot of its ModelGraph, stored as a ModelArchive, instead of parsing the text again.
+/// Snapshots written with any other MODEL_ARCHIVE_VERSION are discarded when read.
+/// The cache is kept under MODEL_CACHE_MAX_BYTES by removing the least recently used snapshots.  Safe to use from any thread.
+@interface ModelCache : NSObject
+
+/// The directory the snapshots are stored in.
+@property NSString* directory;
+
+/// The queue all reads and writes of the cache directory are serialized on.
+@property dispatch_queue_t cacheQueue;
+
+/// The largest number of bytes the snapshots can take up on disk.
+@property unsigned long long maxBytes;
+
++(ModelCache*)sharedModelCache;
+-(id)initWithDirectory:(NSString*)directory maxBytes:(unsigned long long)maxBytes;
+-(ModelGraph*) graphForHash:(NSData*)hash;
+-(void) storeGraph:(ModelGraph*)graph forHash:(NSData*)hash;
+-(void) removeAllGraphs;
+
+@end
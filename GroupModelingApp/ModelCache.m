@@ -0,0 +1,180 @@
+//
+//  ModelCache.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "Constants.h"
+#import "ModelArchive.h"
+#import "ModelCache.h"
+
+@implementation ModelCache
+
+@synthesize directory  = _directory;
+@synthesize cacheQueue = _cacheQueue;
+@synthesize maxBytes   = _maxBytes;
+
+/// Forces the ModelCache to be a singleton class.
+/// The snapshots are stored in the caches directory of the application so the system can remove them if the device runs low on space.
+/// @return a pointer to the single instance of the cache.
++(ModelCache*)sharedModelCache
+{
+    static ModelCache *sharedModelCache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSString* caches = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) objectAtIndex:0];
+        sharedModelCache = [[self alloc] initWithDirectory:[caches stringByAppendingPathComponent:MODEL_CACHE_DIRECTORY]
+                                                  maxBytes:MODEL_CACHE_MAX_BYTES];
+    });
+    return sharedModelCache;
+}
+
+/// Initializes a ModelCache, creating its directory if needed.
+/// @param directory the directory to store the snapshots in.
+/// @param maxBytes the largest number of bytes the snapshots can take up on disk.
+/// @return a pointer to the newly created ModelCache.
+-(id)initWithDirectory:(NSString*)directory maxBytes:(unsigned long long)maxBytes
+{
+    self = [super init];
+    if(self)
+    {
+        self.directory  = directory;
+        self.maxBytes   = maxBytes;
+        self.cacheQueue = dispatch_queue_create(CACHE_QUEUE, DISPATCH_QUEUE_SERIAL);
+        [[NSFileManager defaultManager] createDirectoryAtPath:directory withIntermediateDirectories:YES attributes:nil error:nil];
+    }
+    return self;
+}
+
+/// Creates the path of the snapshot for a file.
+/// @param hash the sha1 hash of the original mdl file.
+/// @return the hash as a hex string within the cache directory.
+-(NSString*) pathForHash:(NSData*)hash
+{
+    const uint8_t* bytes = [hash bytes];
+    NSMutableString* name = [[NSMutableString alloc] initWithCapacity:hash.length * 2];
+    for(NSUInteger i = 0; i < hash.length; ++i)
+    {
+        [name appendFormat:@"%02x", bytes[i]];
+    }
+    return [[self.directory stringByAppendingPathComponent:name] stringByAppendingPathExtension:MODEL_CACHE_EXTENSION];
+}
+
+/// Loads the parsed model of a file from the cache.
+/// A hit marks the snapshot as the most recently used.  A snapshot from a different version of the archive format, or one that cannot be read, is removed.
+/// @param hash the sha1 hash of the original mdl file.
+/// @return the graph of the file, nil if the file is not in the cache.
+-(ModelGraph*) graphForHash:(NSData*)hash
+{
+    if(!hash)
+    {
+        return nil;
+    }
+    
+    __block ModelGraph* graph = nil;
+    dispatch_sync(self.cacheQueue, ^{
+        NSFileManager* manager = [NSFileManager defaultManager];
+        NSString* path = [self pathForHash:hash];
+        NSData* snapshot = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:nil];
+        if(!snapshot)
+        {
+            return;
+        }
+        
+        graph = [[[ModelArchive alloc] initWithData:snapshot] graph];
+        if(graph)
+        {
+            [manager setAttributes:[NSDictionary dictionaryWithObject:[NSDate date] forKey:NSFileModificationDate]
+                      ofItemAtPath:path
+                             error:nil];
+        }
+        else
+        {
+            [manager removeItemAtPath:path error:nil];
+        }
+    });
+    return graph;
+}
+
+/// Stores the parsed model of a file in the cache, then evicts the least recently used snapshots if the cache is over its size.
+/// @param graph the parsed contents of the file.
+/// @param hash the sha1 hash of the original mdl file.
+-(void) storeGraph:(ModelGraph*)graph forHash:(NSData*)hash
+{
+    if(!graph || !hash)
+    {
+        return;
+    }
+    
+    // Encode outside of the queue so other threads are not blocked on it.
+    NSData* snapshot = [ModelArchive dataFromGraph:graph];
+    dispatch_sync(self.cacheQueue, ^{
+        if([snapshot writeToFile:[self pathForHash:hash] atomically:YES])
+        {
+            [self evictLeastRecentlyUsed];
+        }
+    });
+}
+
+/// Removes the least recently used snapshots until the cache is no larger than maxBytes.
+/// @note must be called on the cache queue.
+-(void) evictLeastRecentlyUsed
+{
+    NSFileManager* manager = [NSFileManager defaultManager];
+    NSArray* keys = [NSArray arrayWithObjects:NSURLContentModificationDateKey, NSURLFileSizeKey, nil];
+    NSArray* files = [manager contentsOfDirectoryAtURL:[NSURL fileURLWithPath:self.directory]
+                            includingPropertiesForKeys:keys
+                                               options:NSDirectoryEnumerationSkipsHiddenFiles
+                                                 error:nil];
+    
+    unsigned long long totalBytes = 0;
+    for(NSURL* file in files)
+    {
+        NSNumber* size = nil;
+        [file getResourceValue:&size forKey:NSURLFileSizeKey error:nil];
+        totalBytes += [size unsignedLongLongValue];
+    }
+    if(totalBytes <= self.maxBytes)
+    {
+        return;
+    }
+    
+    // Oldest first.
+    NSArray* sorted = [files sortedArrayUsingComparator:^NSComparisonResult(NSURL* a, NSURL* b) {
+        NSDate* dateA = nil;
+        NSDate* dateB = nil;
+        [a getResourceValue:&dateA forKey:NSURLContentModificationDateKey error:nil];
+        [b getResourceValue:&dateB forKey:NSURLContentModificationDateKey error:nil];
+        return [dateA compare:dateB];
+    }];
+    
+    for(NSURL* file in sorted)
+    {
+        if(totalBytes <= self.maxBytes)
+        {
+            break;
+        }
+        NSNumber* size = nil;
+        [file getResourceValue:&size forKey:NSURLFileSizeKey error:nil];
+        if([manager removeItemAtURL:file error:nil])
+        {
+            totalBytes -= [size unsignedLongLongValue];
+        }
+    }
+}
+
+/// Removes every snapshot from the cache.
+-(void) removeAllGraphs
+{
+    dispatch_sync(self.cacheQueue, ^{
+        NSFileManager* manager = [NSFileManager defaultManager];
+        for(NSString* file in [manager contentsOfDirectoryAtPath:self.directory error:nil])
+        {
+            [manager removeItemAtPath:[self.directory stringByAppendingPathComponent:file] error:nil];
+        }
+    });
+}
+
+@end
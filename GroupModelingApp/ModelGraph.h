@@ -0,0 +1,34 @@
+//
+//  ModelGraph.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "ComponentRecord.h"
+
+/// The contents of a Vensim mdl file as plain data: the simulation control parameters, the default parameters, and a ComponentRecord for every Variable, CausalLink, and Loop.
+/// Causal links refer to their parent and child by id.  A ModelGraph does not create any views so it can be built off of the main thread and without a UI.
+@interface ModelGraph : NSObject
+
+/// The records of every component in the order they appear in the file.
+@property NSMutableArray* records;
+
+/// An array containing all of the simulation control parameters.
+@property NSMutableArray* controlParams;
+
+/// A string containing all of the default parameters including font, and size.  Empty if the file did not contain any.
+@property NSString* defaultParams;
+
+/// The largest component id stored at the end of files saved from the app.  0 if the file did not contain one.
+@property int largestIDNum;
+
+/// The hash of the file the model was opened from.  Only set for a graph recovered from the edit journal, nil otherwise.
+@property NSData* startingHash;
+
+-(id)init;
+-(void) addRecord:(ComponentRecord*)record;
+
+@end
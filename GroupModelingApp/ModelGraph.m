@@ -0,0 +1,41 @@
+//
+//  ModelGraph.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "ModelGraph.h"
+
+@implementation ModelGraph
+
+@synthesize records       = _records;
+@synthesize controlParams = _controlParams;
+@synthesize defaultParams = _defaultParams;
+@synthesize largestIDNum  = _largestIDNum;
+@synthesize startingHash  = _startingHash;
+
+/// Initializes an empty ModelGraph.
+/// @return a pointer to the newly created ModelGraph.
+-(id)init
+{
+    self = [super init];
+    if(self)
+    {
+        self.records       = [[NSMutableArray alloc]init];
+        self.controlParams = [[NSMutableArray alloc]init];
+        self.defaultParams = @"";
+        self.largestIDNum  = 0;
+    }
+    return self;
+}
+
+/// Adds the record of a component to the end of the graph.
+/// @param record the record of a Variable, CausalLink, or Loop.
+-(void) addRecord:(ComponentRecord*)record
+{
+    [self.records addObject:record];
+}
+
+@end
@@ -0,0 +1,66 @@
+//
+//  ModelJournal.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "ModelGraph.h"
+
+@class Model;
+
+/// The operations stored in the edit journal.
+enum JournalOperation
+{
+    JOURNAL_UPSERT        = 1, // A component was added or changed.  Followed by the record of the component.
+    JOURNAL_DELETE        = 2, // A component was deleted.
+    JOURNAL_LARGEST_ID    = 3, // The largest id handed out so far, so ids are not reused after a restore.
+    JOURNAL_STARTING_HASH = 4  // The hash of the file the model started from, so a restored model keeps its place in the research log.  Followed by the hash.
+};
+
+/// A crash safe record of every edit made to the Model since it was last opened or created.
+/// The journal is a snapshot of the model when it was opened, plus an append only log of the components that were added, changed, or deleted since.
+/// Edits are collected on the main thread and written in batches, with a single fsync per batch, so the cost of an edit does not depend on the size of the model.
+/// Once the log grows past MODEL_JOURNAL_COMPACT_BYTES it is folded into a fresh snapshot on a background queue.
+/// On launch, restoreModel rebuilds the model that was open when the application was last killed.
+@interface ModelJournal : NSObject
+
+/// The model whose edits are recorded and restored.  Set by the model the journal is attached to, and weak since the model holds on to its journal.
+@property (weak) Model* model;
+
+/// The directory the snapshot and the log are stored in.
+@property NSString* directory;
+
+/// The queue every write to the snapshot and the log is serialized on.
+@property dispatch_queue_t journalQueue;
+
+/// The open log.  Only used on the journal queue.
+@property NSFileHandle* journalHandle;
+
+/// The number of bytes in the log.  Only used on the journal queue.
+@property unsigned long long journalBytes;
+
+/// The ids of the components that have been edited since the last batch was written, in the order they were edited.  Only used on the main thread.
+@property NSMutableOrderedSet* pendingIDs;
+
+/// Whether a batch is already scheduled to be written.
+@property bool isFlushScheduled;
+
+/// When set, edits are not recorded.  Used while a whole model is being loaded.
+@property bool isSuspended;
+
++(ModelJournal*)sharedModelJournal;
+-(id)initWithDirectory:(NSString*)directory;
+-(void) componentChanged:(int)idNum;
+-(void) flush;
+-(void) flushAndWait;
+-(void) resetWithGraph:(ModelGraph*)graph;
+-(void) startingHashChanged:(NSData*)hash;
+-(ModelGraph*) recoverGraph;
+-(bool) restoreModel;
+-(void) compact;
++(NSUInteger) applyJournal:(NSData*)journal toGraph:(ModelGraph*)graph;
+
+@end
@@ -0,0 +1,475 @@
+//
+//  ModelJournal.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "Constants.h"
+#import "EventLogger.h"
+#import "Model.h"
+#import "ModelArchive.h"
+#import "ModelJournal.h"
+
+/// Every entry of the log starts with the number of bytes in its body followed by a checksum of the body.
+/// An entry that was only partly written when the application was killed fails the checksum, and it and anything after it is ignored.
+struct JournalEntryHeader
+{
+    uint32_t length;
+    uint32_t checksum;
+};
+
+/// Computes the 32 bit FNV-1a hash of the body of an entry.
+/// @param bytes the body of the entry.
+/// @param length the number of bytes in the body.
+/// @return the checksum of the body.
+static uint32_t journalChecksum(const uint8_t* bytes, NSUInteger length)
+{
+    uint32_t hash = 2166136261u;
+    for(NSUInteger i = 0; i < length; ++i)
+    {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/// Appends an entry to a batch of log entries, preceded by its header.
+/// @param batch the entries being written.
+/// @param body the operation and id of the entry, followed by its data.
+static void appendBody(NSMutableData* batch, NSData* body)
+{
+    struct JournalEntryHeader header = { (uint32_t)body.length, journalChecksum(body.bytes, body.length) };
+    [batch appendBytes:&header length:sizeof(header)];
+    [batch appendData:body];
+}
+
+/// Appends an entry to a batch of log entries.  The body is the operation and id, followed by the record for an upsert.
+/// @param batch the entries being written.
+/// @param operation one of the JournalOperation values.
+/// @param idNum the id of the component, or the largest id.
+/// @param record the record of the component for an upsert, nil otherwise.
+static void appendEntry(NSMutableData* batch, int32_t operation, int32_t idNum, ComponentRecord* record)
+{
+    NSMutableData* body = [[NSMutableData alloc] init];
+    [body appendBytes:&operation length:sizeof(operation)];
+    [body appendBytes:&idNum length:sizeof(idNum)];
+    if(record)
+    {
+        [ModelArchive appendRecord:record toData:body];
+    }
+    appendBody(batch, body);
+}
+
+/// Appends the entry holding the hash of the file the model started from to a batch of log entries.
+/// @param batch the entries being written.
+/// @param hash the starting hash of the model, empty for a brand new model.
+static void appendHashEntry(NSMutableData* batch, NSData* hash)
+{
+    int32_t operation = JOURNAL_STARTING_HASH;
+    int32_t idNum     = 0;
+    NSMutableData* body = [[NSMutableData alloc] init];
+    [body appendBytes:&operation length:sizeof(operation)];
+    [body appendBytes:&idNum length:sizeof(idNum)];
+    if(hash)
+    {
+        [body appendData:hash];
+    }
+    appendBody(batch, body);
+}
+
+@implementation ModelJournal
+
+@synthesize model            = _model;
+@synthesize directory        = _directory;
+@synthesize journalQueue     = _journalQueue;
+@synthesize journalHandle    = _journalHandle;
+@synthesize journalBytes     = _journalBytes;
+@synthesize pendingIDs       = _pendingIDs;
+@synthesize isFlushScheduled = _isFlushScheduled;
+@synthesize isSuspended      = _isSuspended;
+
+/// Forces the ModelJournal to be a singleton class.
+/// The journal is kept in the application support directory so that it is not visible to the user and is not removed by the system.
+/// @return a pointer to the single instance of the journal.
++(ModelJournal*)sharedModelJournal
+{
+    static ModelJournal *sharedModelJournal = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSString* support = [NSSearchPathForDirectoriesInDomains(NSApplicationSupportDirectory, NSUserDomainMask, YES) objectAtIndex:0];
+        sharedModelJournal = [[self alloc] initWithDirectory:[support stringByAppendingPathComponent:MODEL_JOURNAL_DIRECTORY]];
+    });
+    return sharedModelJournal;
+}
+
+/// Initializes a ModelJournal, creating its directory if needed.
+/// @param directory the directory to store the snapshot and the log in.
+/// @return a pointer to the newly created ModelJournal.
+-(id)initWithDirectory:(NSString*)directory
+{
+    self = [super init];
+    if(self)
+    {
+        self.directory        = directory;
+        self.journalQueue     = dispatch_queue_create(JOURNAL_QUEUE, DISPATCH_QUEUE_SERIAL);
+        self.pendingIDs       = [[NSMutableOrderedSet alloc] init];
+        self.isFlushScheduled = NO;
+        self.isSuspended      = NO;
+        [[NSFileManager defaultManager] createDirectoryAtPath:directory withIntermediateDirectories:YES attributes:nil error:nil];
+    }
+    return self;
+}
+
+/// Gets the location of the snapshot.
+/// @return the path of the snapshot.
+-(NSString*) snapshotPath
+{
+    return [self.directory stringByAppendingPathComponent:MODEL_JOURNAL_SNAPSHOT];
+}
+
+/// Gets the location of the log.
+/// @return the path of the log.
+-(NSString*) journalPath
+{
+    return [self.directory stringByAppendingPathComponent:MODEL_JOURNAL_LOG];
+}
+
+/// Records that a component was added, changed, or deleted.  Must be called on the main thread.
+/// The current state of the component is read when the batch is written, so any number of edits to the same component between batches cost a single entry.
+/// @param idNum the id of the component.
+-(void) componentChanged:(int)idNum
+{
+    if(self.isSuspended)
+    {
+        return;
+    }
+    
+    [self.pendingIDs addObject:[NSNumber numberWithInt:idNum]];
+    if(!self.isFlushScheduled)
+    {
+        self.isFlushScheduled = YES;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(MODEL_JOURNAL_FLUSH_DELAY * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            [self flush];
+        });
+    }
+}
+
+/// Creates the log entries for every component edited since the last batch.  Must be called on the main thread.
+/// @return the entries to append to the log, nil if there were no edits.
+-(NSData*) takePendingEntries
+{
+    self.isFlushScheduled = NO;
+    if(self.pendingIDs.count == 0 || !self.model)
+    {
+        return nil;
+    }
+    
+    NSMutableData* batch = [[NSMutableData alloc] init];
+    Model* model = self.model;
+    for(NSNumber* idNum in self.pendingIDs)
+    {
+        // A component that is no longer in the model has been deleted.
+        Component* compo = [model getComponent:[idNum intValue]];
+        ComponentRecord* record = nil;
+        if([compo isMemberOfClass:[Variable class]])
+        {
+            record = [(Variable*)compo createRecord];
+        }
+        else if([compo isMemberOfClass:[CausalLink class]])
+        {
+            record = [(CausalLink*)compo createRecord];
+        }
+        else if([compo isMemberOfClass:[Loop class]])
+        {
+            record = [(Loop*)compo createRecord];
+        }
+        appendEntry(batch, (record) ? JOURNAL_UPSERT : JOURNAL_DELETE, [idNum intValue], record);
+    }
+    appendEntry(batch, JOURNAL_LARGEST_ID, [model.idAllocator largestID], nil);
+    [self.pendingIDs removeAllObjects];
+    
+    return batch;
+}
+
+/// Writes the edits made since the last batch to the log in the background.  Must be called on the main thread.
+-(void) flush
+{
+    NSData* batch = [self takePendingEntries];
+    if(batch)
+    {
+        dispatch_async(self.journalQueue, ^{
+            [self writeBatch:batch];
+        });
+    }
+}
+
+/// Writes the edits made since the last batch to the log and waits for them to reach the disk.  Must be called on the main thread.
+/// Used when the application is about to be suspended or terminated.
+-(void) flushAndWait
+{
+    NSData* batch = [self takePendingEntries];
+    dispatch_sync(self.journalQueue, ^{
+        if(batch)
+        {
+            [self writeBatch:batch];
+        }
+    });
+}
+
+/// Opens the log for appending.  Anything after the last complete entry is cut off so new entries are not written after a partial one.
+/// @note must be called on the journal queue.
+-(void) openJournal
+{
+    if(self.journalHandle)
+    {
+        return;
+    }
+    
+    NSString* path = [self journalPath];
+    if(![[NSFileManager defaultManager] fileExistsAtPath:path])
+    {
+        [[NSFileManager defaultManager] createFileAtPath:path contents:nil attributes:nil];
+    }
+    
+    NSData* journal = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:nil];
+    NSUInteger validLength = [ModelJournal applyJournal:journal toGraph:nil];
+    
+    self.journalHandle = [NSFileHandle fileHandleForWritingAtPath:path];
+    [self.journalHandle truncateFileAtOffset:validLength];
+    self.journalBytes = validLength;
+}
+
+/// Appends a batch of entries to the log and forces it to disk, then compacts the log if it has grown too large.
+/// @note must be called on the journal queue.
+/// @param batch the entries to append.
+-(void) writeBatch:(NSData*)batch
+{
+    [self openJournal];
+    [self.journalHandle writeData:batch];
+    fsync([self.journalHandle fileDescriptor]);
+    self.journalBytes += batch.length;
+    
+    if(self.journalBytes > MODEL_JOURNAL_COMPACT_BYTES)
+    {
+        [self compact];
+    }
+}
+
+/// Replaces the snapshot with a graph and empties the log.  Called whenever a model is opened or created, since the file itself is the starting point of the edits.
+/// Must be called on the main thread.
+/// @param graph the graph of the model as it was opened.
+-(void) resetWithGraph:(ModelGraph*)graph
+{
+    if(self.isSuspended)
+    {
+        return;
+    }
+    
+    [self.pendingIDs removeAllObjects];
+    
+    // Ids are handed out from the largest id in the model, which may not be stored in the graph.  Neither is the hash of the file the model was opened from.
+    NSMutableData* batch = [[NSMutableData alloc] init];
+    appendEntry(batch, JOURNAL_LARGEST_ID, [self.model.idAllocator largestID], nil);
+    appendHashEntry(batch, self.model.startingHash);
+    
+    dispatch_async(self.journalQueue, ^{
+        [self writeSnapshot:[ModelArchive dataFromGraph:graph]];
+        [self writeBatch:batch];
+    });
+}
+
+/// Records that the model now starts from a different file, such as after it was uploaded.  Must be called on the main thread.
+/// @param hash the new starting hash of the model.
+-(void) startingHashChanged:(NSData*)hash
+{
+    if(self.isSuspended)
+    {
+        return;
+    }
+    
+    NSMutableData* batch = [[NSMutableData alloc] init];
+    appendHashEntry(batch, hash);
+    dispatch_async(self.journalQueue, ^{
+        [self writeBatch:batch];
+    });
+}
+
+/// Atomically replaces the snapshot, then empties the log.
+/// If the application is killed in between, the log is replayed over a snapshot that already contains it, which has the same result since every entry replaces or removes a component by id.
+/// @note must be called on the journal queue.
+/// @param snapshot the new snapshot.
+-(void) writeSnapshot:(NSData*)snapshot
+{
+    [snapshot writeToFile:[self snapshotPath] options:NSDataWritingAtomic error:nil];
+    
+    [self openJournal];
+    [self.journalHandle truncateFileAtOffset:0];
+    fsync([self.journalHandle fileDescriptor]);
+    self.journalBytes = 0;
+}
+
+/// Reads the snapshot and replays the log over it.
+/// @note must be called on the journal queue.
+/// @return the graph of the model after every journaled edit, nil if there is no journal.
+-(ModelGraph*) readGraph
+{
+    NSData* snapshot = [NSData dataWithContentsOfFile:[self snapshotPath] options:NSDataReadingMappedIfSafe error:nil];
+    NSData* journal  = [NSData dataWithContentsOfFile:[self journalPath] options:NSDataReadingMappedIfSafe error:nil];
+    if(!snapshot && !journal)
+    {
+        return nil;
+    }
+    
+    ModelGraph* graph = [[[ModelArchive alloc] initWithData:snapshot] graph];
+    if(!graph)
+    {
+        graph = [[ModelGraph alloc] init];
+    }
+    [ModelJournal applyJournal:journal toGraph:graph];
+    return graph;
+}
+
+/// Folds the log into a fresh snapshot so the log does not grow without bound.
+/// The snapshot does not hold the starting hash, so it is written again as the first entry of the new log.
+/// @note must be called on the journal queue.
+-(void) compact
+{
+    ModelGraph* graph = [self readGraph];
+    if(graph)
+    {
+        [self writeSnapshot:[ModelArchive dataFromGraph:graph]];
+        if(graph.startingHash)
+        {
+            NSMutableData* batch = [[NSMutableData alloc] init];
+            appendHashEntry(batch, graph.startingHash);
+            [self writeBatch:batch];
+        }
+    }
+}
+
+/// Reads the model as it was when the application last stopped.
+/// @return the graph of the model after every journaled edit, nil if there is no journal.
+-(ModelGraph*) recoverGraph
+{
+    __block ModelGraph* graph = nil;
+    dispatch_sync(self.journalQueue, ^{
+        graph = [self readGraph];
+    });
+    return graph;
+}
+
+/// Rebuilds the model that was open when the application last stopped, along with the hash of the file it started from, then folds the log into a fresh snapshot.  Must be called on the main thread once the model view is displayed.
+/// @return true if a model was restored, false if there was nothing to restore.
+-(bool) restoreModel
+{
+    ModelGraph* graph = [self recoverGraph];
+    if(!graph || graph.records.count == 0 || !self.model)
+    {
+        return false;
+    }
+    
+    self.isSuspended = YES;
+    Model* model = self.model;
+    model.startingHash = (graph.startingHash) ? graph.startingHash : [NSData data];
+    [model createComponents:graph];
+    [model connectCausalLinks];
+    [model materializeViews];
+    self.isSuspended = NO;
+    
+    [self resetWithGraph:graph];
+    
+    [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID:RESTORED_MODEL
+                                                                andDetails:[NSString stringWithFormat:NUMBER_RESTORED, (int)graph.records.count]]];
+    return true;
+}
+
+/// Replays the entries of a log over a graph.
+/// An upsert replaces the record with the same id in place, or adds it to the end.  A delete removes the record with the id.
+/// @param journal the contents of the log.
+/// @param graph the graph to apply the entries to.  May be nil to only validate the log.
+/// @return the number of bytes of complete entries at the start of the log.
++(NSUInteger) applyJournal:(NSData*)journal toGraph:(ModelGraph*)graph
+{
+    const uint8_t* bytes = [journal bytes];
+    NSUInteger length    = [journal length];
+    NSUInteger offset    = 0;
+    
+    // Find the location of every record by id.
+    NSMutableDictionary* indexes = [[NSMutableDictionary alloc] init];
+    for(NSUInteger i = 0; i < graph.records.count; ++i)
+    {
+        ComponentRecord* record = [graph.records objectAtIndex:i];
+        [indexes setObject:[NSNumber numberWithUnsignedInteger:i] forKey:[NSNumber numberWithInt:record.idNum]];
+    }
+    
+    while(length - offset >= sizeof(struct JournalEntryHeader))
+    {
+        struct JournalEntryHeader header;
+        memcpy(&header, bytes + offset, sizeof(header));
+        NSUInteger bodyStart = offset + sizeof(header);
+        if(header.length < 2 * sizeof(int32_t) || length - bodyStart < header.length ||
+           journalChecksum(bytes + bodyStart, header.length) != header.checksum)
+        {
+            break;
+        }
+        
+        int32_t operation, idNum;
+        memcpy(&operation, bytes + bodyStart, sizeof(operation));
+        memcpy(&idNum, bytes + bodyStart + sizeof(operation), sizeof(idNum));
+        NSNumber* key   = [NSNumber numberWithInt:idNum];
+        NSNumber* index = [indexes objectForKey:key];
+        
+        switch(operation)
+        {
+            case JOURNAL_UPSERT:
+            {
+                ComponentRecord* record = [ModelArchive recordFromBytes:bytes + bodyStart + 2 * sizeof(int32_t)
+                                                                 length:header.length - 2 * sizeof(int32_t)];
+                if(!record)
+                {
+                    break;
+                }
+                if(index)
+                {
+                    [graph.records replaceObjectAtIndex:[index unsignedIntegerValue] withObject:record];
+                }
+                else if(graph)
+                {
+                    [indexes setObject:[NSNumber numberWithUnsignedInteger:graph.records.count] forKey:key];
+                    [graph addRecord:record];
+                }
+                break;
+            }
+            case JOURNAL_DELETE:
+            {
+                // Leave a placeholder so the indexes of the other records do not change.
+                if(index)
+                {
+                    [graph.records replaceObjectAtIndex:[index unsignedIntegerValue] withObject:[NSNull null]];
+                    [indexes removeObjectForKey:key];
+                }
+                break;
+            }
+            case JOURNAL_LARGEST_ID:
+            {
+                graph.largestIDNum = MAX(graph.largestIDNum, idNum);
+                break;
+            }
+            case JOURNAL_STARTING_HASH:
+            {
+                graph.startingHash = [NSData dataWithBytes:bytes + bodyStart + 2 * sizeof(int32_t)
+                                                    length:header.length - 2 * sizeof(int32_t)];
+                break;
+            }
+            default:
+                break;
+        }
+        offset = bodyStart + header.length;
+    }
+    
+    [graph.records removeObjectIdenticalTo:[NSNull null]];
+    return offset;
+}
+
+@end
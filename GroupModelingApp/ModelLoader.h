@@ -0,0 +1,63 @@
+//
+//  ModelLoader.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "ModelCache.h"
+#import "ModelGraph.h"
+#import "ModelParser.h"
+
+/// The stages a model file goes through while it is being opened.
+enum LoadStage
+{
+    LOAD_FETCH  = 0, // Downloading or reading the file.
+    LOAD_HASH   = 1, // Taking the sha1 hash of the file for logging purposes.
+    LOAD_PARSE  = 2, // Parsing the file into a ModelGraph.
+    LOAD_COMMIT = 3  // Creating the components on the main thread.  Done by the caller in the completion block.
+};
+
+/// Opens a Vensim mdl file off of the main thread.
+/// The file is fetched, hashed, and parsed into a detached ModelGraph on a background queue.  Once finished, the completion block is called on the main thread so the graph can be committed to the Model in a single step.
+/// None of the background stages touch the UI, so runStages can also be called directly against a local file url.
+@interface ModelLoader : NSObject
+
+/// The location of the file to open.  Can be a remote url or a local file url.
+@property NSURL* url;
+
+/// The asynchronous queue the background stages run on.
+@property dispatch_queue_t loadQueue;
+
+/// The parser used for the parse stage.  Kept so that a cancel can stop a parse in progress.
+@property ModelParser* parser;
+
+/// The cache parsed files are looked up in and stored to.  The shared ModelCache unless it is replaced before the load starts.
+@property ModelCache* cache;
+
+/// Whether the load has been cancelled.
+@property volatile bool isCancelled;
+
+/// The raw contents of the file.  Set by the fetch stage.
+@property NSData* data;
+
+/// The sha1 hash of the file.  Set by the hash stage.
+@property NSData* fileHash;
+
+/// The parsed contents of the file.  Set by the parse stage.
+@property ModelGraph* graph;
+
+/// Any error that caused a stage to fail.
+@property NSError* error;
+
+/// Whether the graph was loaded from the ModelCache instead of being parsed.
+@property bool isFromCache;
+
+-(id)initWithURL:(NSURL*)url;
+-(void)loadWithProgress:(void (^)(int stage, float fraction))progress completion:(void (^)(ModelLoader* loader))completion;
+-(bool)runStages:(void (^)(int stage, float fraction))progress;
+-(void)cancel;
+
+@end
@@ -0,0 +1,148 @@
+//
+//  ModelLoader.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <CommonCrypto/CommonDigest.h>
+#import "Constants.h"
+#import "ModelLoader.h"
+
+@implementation ModelLoader
+
+@synthesize url         = _url;
+@synthesize loadQueue   = _loadQueue;
+@synthesize parser      = _parser;
+@synthesize cache       = _cache;
+@synthesize isCancelled = _isCancelled;
+@synthesize data        = _data;
+@synthesize fileHash    = _fileHash;
+@synthesize graph       = _graph;
+@synthesize error       = _error;
+@synthesize isFromCache = _isFromCache;
+
+/// Initializes the ModelLoader.
+/// @param url the location of the file to open.
+/// @return a pointer to the newly created ModelLoader.
+-(id)initWithURL:(NSURL*)url
+{
+    self = [super init];
+    if(self)
+    {
+        self.url         = url;
+        self.loadQueue   = dispatch_queue_create(LOAD_QUEUE, DISPATCH_QUEUE_SERIAL);
+        self.parser      = [[ModelParser alloc] init];
+        self.cache       = [ModelCache sharedModelCache];
+        self.isCancelled = NO;
+    }
+    return self;
+}
+
+/// Runs the fetch, hash, and parse stages on the load queue.
+/// The progress and completion blocks are always called on the main thread.  The completion block is not called if the load was cancelled.
+/// @param progress called with the current stage and the fraction of that stage that is complete. May be nil.
+/// @param completion called once all stages have finished.  The graph of the loader will be nil if a stage failed.
+-(void)loadWithProgress:(void (^)(int stage, float fraction))progress completion:(void (^)(ModelLoader* loader))completion
+{
+    // Forward progress from the load queue to the main thread.
+    void (^mainProgress)(int, float) = nil;
+    if(progress)
+    {
+        mainProgress = ^(int stage, float fraction) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                // Updates queued before a cancel must not reach a caller that has already torn down its progress display.
+                if(!self.isCancelled)
+                {
+                    progress(stage, fraction);
+                }
+            });
+        };
+    }
+    
+    dispatch_async(self.loadQueue, ^{
+        [self runStages:mainProgress];
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            // A cancel may have come in after the stages finished, check again on the main thread.
+            if(!self.isCancelled)
+            {
+                if(progress)
+                {
+                    progress(LOAD_COMMIT, 0.0);
+                }
+                completion(self);
+            }
+        });
+    });
+}
+
+/// Runs the fetch, hash, and parse stages on the calling thread.
+/// @param progress called with the current stage and the fraction of that stage that is complete. May be nil.
+/// @return true if the file was parsed, false if a stage failed or the load was cancelled.
+-(bool)runStages:(void (^)(int stage, float fraction))progress
+{
+    // Fetch the file.  Local files are always mapped rather than read so they are never copied into memory.
+    // The parser reads the mapped bytes in place, and the pages it has finished with are backed by the file so the system can reclaim them.
+    if(progress) progress(LOAD_FETCH, 0.0);
+    NSError* error = nil;
+    NSDataReadingOptions options = [self.url isFileURL] ? NSDataReadingMappedAlways : 0;
+    self.data = [NSData dataWithContentsOfURL:self.url options:options error:&error];
+    if(!self.data || self.isCancelled)
+    {
+        self.error = error;
+        return false;
+    }
+    
+    // Take a hash of the original file for logging purposes.
+    // Hashed here rather than through FileIO so the background stages do not depend on UIKit.
+    if(progress) progress(LOAD_HASH, 0.0);
+    unsigned char hash[CC_SHA1_DIGEST_LENGTH];
+    CC_SHA1([self.data bytes], (CC_LONG)[self.data length], hash);
+    self.fileHash = [NSData dataWithBytes:hash length:CC_SHA1_DIGEST_LENGTH];
+    if(self.isCancelled)
+    {
+        return false;
+    }
+    
+    // A file that has been opened before does not need to be parsed again.
+    self.graph = [self.cache graphForHash:self.fileHash];
+    if(self.graph)
+    {
+        self.isFromCache = YES;
+        self.data        = nil;
+        if(progress) progress(LOAD_PARSE, 1.0);
+        return !self.isCancelled;
+    }
+    
+    // Parse the file into a detached graph. The parser only decodes the fields it keeps, so there is no separate decode of the whole file.
+    if(progress)
+    {
+        self.parser.progressHandler = ^(float fraction) {
+            progress(LOAD_PARSE, fraction);
+        };
+    }
+    self.graph = [self.parser parseData:self.data];
+    self.parser.progressHandler = nil;
+    
+    // The raw data is no longer needed once it has been parsed.
+    self.data = nil;
+    
+    // Keep the parsed graph so the next time this file is opened it can be loaded directly.
+    if(self.graph && !self.isCancelled)
+    {
+        [self.cache storeGraph:self.graph forHash:self.fileHash];
+    }
+    
+    return self.graph != nil && !self.isCancelled;
+}
+
+/// Stops the load.  Safe to call from any thread, the completion block will not be called.
+-(void)cancel
+{
+    self.isCancelled        = YES;
+    self.parser.isCancelled = YES;
+}
+
+@end
@@ -0,0 +1,28 @@
+//
+//  ModelParser.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "ModelGraph.h"
+
+/// Parses the contents of a Vensim mdl file into a ModelGraph.
+/// Large sketch sections are parsed in chunks across all cores.
+/// Only depends on Foundation so that a file can be parsed off of the main thread, and without a UI.
+@interface ModelParser : NSObject
+
+/// Set from any thread to stop a parse that is in progress.  parseData: will return nil once it notices.
+@property volatile bool isCancelled;
+
+/// Called periodically during a parse with the fraction of the file that has been read, from 0 to 1.  May be nil.
+@property (copy) void (^progressHandler)(float fraction);
+
+-(ModelGraph*) parseData:(NSData*)data;
+-(NSUInteger) parseControls:(const char*)bytes length:(NSUInteger)length into:(ModelGraph*)graph;
+-(ModelGraph*) parseSketch:(const char*)bytes from:(NSUInteger)start to:(NSUInteger)end endFound:(bool*)endFound;
++(NSString*) stringFromBytes:(const char*)bytes length:(NSUInteger)length;
+
+@end
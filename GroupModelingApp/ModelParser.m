@@ -0,0 +1,347 @@
+//
+//  ModelParser.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+// Foundation on OS X brings these in, GNUstep's Foundation does not.
+#import <dispatch/dispatch.h>
+#import <stdlib.h>
+#import <string.h>
+#import "Constants.h"
+#import "ModelParser.h"
+#import "RecordScanner.h"
+
+/// How many lines are read between checks for cancellation and progress updates.
+#define PARSE_PROGRESS_INTERVAL 1024
+
+/// The smallest number of bytes of sketch information given to a chunk.  Smaller files are parsed as a single chunk.
+#define PARSE_CHUNK_MIN_BYTES   (64 * 1024)
+
+/// How many chunks the sketch information is split into per core, so that a slow chunk does not hold up the others.
+#define PARSE_CHUNKS_PER_CORE   4
+
+/// The sections of a Vensim mdl file that the importer moves through while reading the file top to bottom.
+enum ImportState
+{
+    READ_EQUATIONS  = 0, // The variable maps at the top of the file.  These are rebuilt on export so they are skipped.
+    READ_CONTROLS   = 1, // The simulation control parameters.
+    READ_COMPONENTS = 2, // The sketch information containing every Variable, CausalLink, and Loop.
+    READ_TRAILER    = 3  // Anything Vensim outputs after the sketch information.  Ignored.
+};
+
+/// Determines if a line of the file starts with a given prefix without having to create a string for the line.
+/// @param line a pointer to the first byte of the line.
+/// @param length the number of bytes in the line.
+/// @param prefix the null terminated prefix to look for.
+/// @param prefixLength the number of bytes in the prefix.
+/// @return true if the line begins with the prefix.
+static bool lineHasPrefix(const char* line, NSUInteger length, const char* prefix, NSUInteger prefixLength)
+{
+    return length >= prefixLength && memcmp(line, prefix, prefixLength) == 0;
+}
+
+/// Reads the leading integer of a sketch line which holds the type of the component.
+/// @param line a pointer to the first byte of the line.
+/// @param length the number of bytes in the line.
+/// @return the object type of the line, 0 if the line does not start with a number.
+static int lineObjectType(const char* line, NSUInteger length)
+{
+    int value = 0;
+    for(NSUInteger i = 0; i < length && line[i] >= '0' && line[i] <= '9'; ++i)
+    {
+        value = value * 10 + (line[i] - '0');
+    }
+    return value;
+}
+
+/// Finds the start of the line a chunk of the sketch information should begin at.
+/// The boundary is moved forward to the start of the next line, then past one more line if it would separate a Loop from the line holding its name.
+/// A line starting with the loop type could itself be the name of a loop, so the run of such lines before the boundary is counted; an odd count means the last one is a Loop.
+/// @param bytes the raw contents of the file.
+/// @param start the offset of the first line of the sketch information.
+/// @param end the offset one past the end of the sketch information.
+/// @param offset the approximate location of the boundary.
+/// @return the offset of the first line of the chunk.
+static NSUInteger chunkBoundary(const char* bytes, NSUInteger start, NSUInteger end, NSUInteger offset)
+{
+    if(offset <= start)
+    {
+        return start;
+    }
+    if(offset >= end)
+    {
+        return end;
+    }
+    
+    // Move to the start of the next line.
+    if(bytes[offset - 1] != '\n')
+    {
+        const char* newline = memchr(bytes + offset, '\n', end - offset);
+        offset = newline ? (NSUInteger)(newline - bytes) + 1 : end;
+    }
+    
+    // Count the lines directly before the boundary that start with the loop type.
+    NSUInteger loopLines = 0;
+    NSUInteger lineEnd   = offset;
+    while(lineEnd > start)
+    {
+        NSUInteger lineStart = lineEnd - 1;
+        while(lineStart > start && bytes[lineStart - 1] != '\n')
+        {
+            --lineStart;
+        }
+        if(lineObjectType(bytes + lineStart, lineEnd - 1 - lineStart) != LOOP)
+        {
+            break;
+        }
+        ++loopLines;
+        lineEnd = lineStart;
+    }
+    
+    // Keep the name of the loop in the same chunk as the loop.
+    if(loopLines % 2 == 1 && offset < end)
+    {
+        const char* newline = memchr(bytes + offset, '\n', end - offset);
+        offset = newline ? (NSUInteger)(newline - bytes) + 1 : end;
+    }
+    return offset;
+}
+
+@implementation ModelParser
+
+@synthesize isCancelled     = _isCancelled;
+@synthesize progressHandler = _progressHandler;
+
+/// Parses a Vensim mdl file into a ModelGraph.
+/// The equations and simulation control parameters are read first.  The sketch information that follows is split into chunks at line boundaries which are parsed across all cores, since the records do not depend on each other until the Model connects the causal links.
+/// The partial graphs are merged in file order so the records come out in the same order as a sequential parse.
+/// @param data the raw contents of the mdl file.
+/// @return a graph containing the simulation control parameters, default model parameters, and a record of every Variable, CausalLink, and Loop.  nil if the parse was cancelled.
+-(ModelGraph*) parseData:(NSData*)data
+{
+    ModelGraph* graph = [[ModelGraph alloc] init];
+
+    const char* bytes  = [data bytes];
+    NSUInteger  length = [data length];
+    
+    NSUInteger sketchStart = [self parseControls:bytes length:length into:graph];
+    if(self.isCancelled)
+    {
+        return nil;
+    }
+    
+    // Small files are not worth splitting up.
+    NSUInteger sketchLength = length - sketchStart;
+    size_t chunkCount = MIN(sketchLength / PARSE_CHUNK_MIN_BYTES,
+                            [[NSProcessInfo processInfo] activeProcessorCount] * PARSE_CHUNKS_PER_CORE);
+    chunkCount = MAX(chunkCount, (size_t)1);
+    
+    // Split the sketch information into roughly equal chunks.
+    NSUInteger* bounds = malloc((chunkCount + 1) * sizeof(NSUInteger));
+    bounds[0] = sketchStart;
+    for(size_t i = 1; i < chunkCount; ++i)
+    {
+        bounds[i] = MAX(bounds[i - 1], chunkBoundary(bytes, sketchStart, length, sketchStart + (sketchLength / chunkCount) * i));
+    }
+    bounds[chunkCount] = length;
+    
+    // Parse the chunks.  Each chunk only writes to its own slot.
+    NSMutableArray* partials = [[NSMutableArray alloc] initWithCapacity:chunkCount];
+    for(size_t i = 0; i < chunkCount; ++i)
+    {
+        [partials addObject:[NSNull null]];
+    }
+    bool* endFound = calloc(chunkCount, sizeof(bool));
+    __block NSUInteger parsedBytes = sketchStart;
+    
+    dispatch_apply(chunkCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        ModelGraph* partial = [self parseSketch:bytes from:bounds[i] to:bounds[i + 1] endFound:&endFound[i]];
+        @synchronized(partials)
+        {
+            [partials replaceObjectAtIndex:i withObject:(partial) ? (id)partial : (id)[NSNull null]];
+            parsedBytes += bounds[i + 1] - bounds[i];
+            if(self.progressHandler && length > 0)
+            {
+                self.progressHandler((float)parsedBytes / length);
+            }
+        }
+    });
+    
+    // Merge the chunks in file order, stopping at the end of the sketch information.
+    for(size_t i = 0; i < chunkCount && !self.isCancelled; ++i)
+    {
+        ModelGraph* partial = [partials objectAtIndex:i];
+        if([partial isKindOfClass:[NSNull class]])
+        {
+            break;
+        }
+        [graph.records addObjectsFromArray:partial.records];
+        if(partial.defaultParams.length > 0)
+        {
+            [graph setDefaultParams:partial.defaultParams];
+        }
+        if(partial.largestIDNum > 0)
+        {
+            [graph setLargestIDNum:partial.largestIDNum];
+        }
+        if(endFound[i])
+        {
+            break;
+        }
+    }
+    free(bounds);
+    free(endFound);
+
+    if(self.progressHandler)
+    {
+        self.progressHandler(1.0);
+    }
+    return (self.isCancelled) ? nil : graph;
+}
+
+/// Reads the simulation control parameters at the top of a Vensim mdl file, skipping over the variable maps.
+/// @param bytes the raw contents of the file.
+/// @param length the number of bytes in the file.
+/// @param graph the graph to add the control parameters to.
+/// @return the offset of the first line of the sketch information, the length of the file if there is none.
+-(NSUInteger) parseControls:(const char*)bytes length:(NSUInteger)length into:(ModelGraph*)graph
+{
+    const char* componentPrefix = [COMPONENT_PREFIX UTF8String];
+    const char* controlPrefix   = [SIM_CONTROL_PARAMS_PREFIX UTF8String];
+    
+    enum ImportState state = READ_EQUATIONS;
+    NSUInteger cursor      = 0;
+    NSUInteger lineCount   = 0;
+    
+    while(cursor < length)
+    {
+        // Periodically check if the parse should stop and report how far along it is.
+        if(++lineCount % PARSE_PROGRESS_INTERVAL == 0)
+        {
+            if(self.isCancelled)
+            {
+                return length;
+            }
+            if(self.progressHandler)
+            {
+                self.progressHandler((float)cursor / length);
+            }
+        }
+        
+        // Find the end of the current line.
+        const char* line    = bytes + cursor;
+        const char* newline = memchr(line, '\n', length - cursor);
+        NSUInteger lineLength = newline ? (NSUInteger)(newline - line) : length - cursor;
+        cursor += lineLength + 1;
+        
+        // The start of the sketch information ends the control parameters.
+        // Vensim files do not need to contain control parameters, so this can come directly after the equations.
+        if(lineLength > COMPONENT_PREFIX.length && lineHasPrefix(line, lineLength, componentPrefix, COMPONENT_PREFIX.length))
+        {
+            return MIN(cursor, length);
+        }
+        
+        // Skip over the variable maps until the simulation control parameters are found.
+        if(state == READ_EQUATIONS && lineHasPrefix(line, lineLength, controlPrefix, SIM_CONTROL_PARAMS_PREFIX.length))
+        {
+            state = READ_CONTROLS;
+        }
+        if(state == READ_CONTROLS)
+        {
+            [graph.controlParams addObject:[ModelParser stringFromBytes:line length:lineLength]];
+        }
+    }
+    return length;
+}
+
+/// Parses a chunk of the sketch information of a Vensim mdl file into a partial graph.
+/// Safe to call for different chunks of the same file at the same time.
+/// @param bytes the raw contents of the file.
+/// @param start the offset of the first line of the chunk.
+/// @param end the offset one past the end of the chunk.
+/// @param endFound set to true if the chunk contains the end of the sketch information.  Anything after it is ignored.
+/// @return a graph with the records, default parameters, and largest id found in the chunk.  nil if the parse was cancelled.
+-(ModelGraph*) parseSketch:(const char*)bytes from:(NSUInteger)start to:(NSUInteger)end endFound:(bool*)endFound
+{
+    ModelGraph* graph = [[ModelGraph alloc] init];
+    
+    const char* defaultPrefix   = [DEFAULT_PARAMS_PREFIX UTF8String];
+    const char* endPrefix       = [END_OF_COMPONENTS UTF8String];
+    const char* largestIDPrefix = [LARGEST_COMPONENT_ID UTF8String];
+    
+    // A single scanner is reused for every sketch record in the chunk.
+    RecordScanner* record = [[RecordScanner alloc] initWithBytes:bytes length:0];
+    NSUInteger cursor     = start;
+    NSUInteger lineCount  = 0;
+    
+    while(cursor < end)
+    {
+        if(++lineCount % PARSE_PROGRESS_INTERVAL == 0 && self.isCancelled)
+        {
+            return nil;
+        }
+        
+        // Find the end of the current line.
+        const char* line    = bytes + cursor;
+        const char* newline = memchr(line, '\n', end - cursor);
+        NSUInteger lineLength = newline ? (NSUInteger)(newline - line) : end - cursor;
+        cursor += lineLength + 1;
+        
+        // Stop reading components data when there are no more. Vensim sometimes outputs more information at the end of the file.
+        if(lineHasPrefix(line, lineLength, endPrefix, END_OF_COMPONENTS.length))
+        {
+            *endFound = true;
+            break;
+        }
+        // Read in default parameters
+        else if(lineHasPrefix(line, lineLength, defaultPrefix, DEFAULT_PARAMS_PREFIX.length))
+        {
+            [graph setDefaultParams:[ModelParser stringFromBytes:line length:lineLength]];
+        }
+        // Get the largest component id, if it is there.  The id will only exist if the the file being loaded had been saved previously from the app.
+        // Otherwise if the file was originally created from Vensim, the last object will have the highest id and the largestIDNum will be set automatically.
+        // This string will actually exist after all components.
+        else if(lineHasPrefix(line, lineLength, largestIDPrefix, LARGEST_COMPONENT_ID.length))
+        {
+            [record resetWithBytes:line + LARGEST_COMPONENT_ID.length length:lineLength - LARGEST_COMPONENT_ID.length];
+            [graph setLargestIDNum:[record intAtField:0]];
+        }
+        else // Read the component.
+        {
+            // The name of a loop is stored on the line following the rest of the loop's attributes.
+            // Consume that line here so that it is not read as a component of its own.  Chunks never separate the two lines.
+            NSString* loopName = @"";
+            if(lineObjectType(line, lineLength) == LOOP && cursor < end)
+            {
+                const char* nameLine = bytes + cursor;
+                const char* nameEnd  = memchr(nameLine, '\n', end - cursor);
+                NSUInteger nameLength = nameEnd ? (NSUInteger)(nameEnd - nameLine) : end - cursor;
+                cursor += nameLength + 1;
+                loopName = [ModelParser stringFromBytes:nameLine length:nameLength];
+            }
+            // Only keep the three types of components the application uses.
+            [record resetWithBytes:line length:lineLength];
+            int type = [record intAtField:0];
+            if(type == CAUSAL_LINK || type == VARIABLE || type == LOOP)
+            {
+                [graph addRecord:[[ComponentRecord alloc] initWithRecord:record loopName:loopName]];
+            }
+        }
+    }
+    return graph;
+}
+
+/// Creates a string from a single line of the file being imported.
+/// @param bytes a pointer to the first byte of the line.
+/// @param length the number of bytes in the line.
+/// @return the line decoded as UTF-8, an empty string if the line is not valid UTF-8.
++(NSString*) stringFromBytes:(const char*)bytes length:(NSUInteger)length
+{
+    NSString* string = [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+    return (string) ? string : @"";
+}
+
+@end
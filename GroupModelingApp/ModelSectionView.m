@@ -97,7 +97,9 @@
         case VARIABLE_INDEX:
         {
             Variable* newVar = [[Variable alloc]initWithLocation:touchLoc];
+            [[Model sharedModel].history beginStep];
             [[Model sharedModel] addComponent:newVar];
+            [[Model sharedModel].history endStepWithDescID:ADD_VARIABLE andObjectID:newVar.idNum];
             [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID: ADD_VARIABLE andObjectID:newVar.idNum]];
             
             // Let the edit menu appear when a new variable is added.
@@ -109,7 +111,9 @@
         case LOOP_INDEX:
         {
             Loop* newLoop = [[Loop alloc]initWithLocation:touchLoc];
+            [[Model sharedModel].history beginStep];
             [[Model sharedModel] addComponent:newLoop];
+            [[Model sharedModel].history endStepWithDescID:ADD_LOOP andObjectID:newLoop.idNum];
             [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID: ADD_LOOP andObjectID:newLoop.idNum]];
             break;
         }
@@ -7,6 +7,8 @@
 //
 
 #import "CausalLinkView.h"
+#import "LoopFinder.h"
+#import "ModelLoader.h"
 #import "ModelSectionView.h"
 #import "Reachability.h"
 #import <UIKit/UIKit.h>
@@ -19,6 +21,13 @@ enum Segcontrol
     LOOP_INDEX     = 2,
 };
 
+/// The undo control index locations.
+enum UndoControl
+{
+    UNDO_INDEX = 0,
+    REDO_INDEX = 1
+};
+
 /// The view controller that handles interaction with the model section.
 @interface ModelSectionViewController : UIViewController <UIDocumentInteractionControllerDelegate, UIPopoverControllerDelegate>
 
@@ -43,6 +52,9 @@ enum Segcontrol
 /// The button that will save files.
 @property UIBarButtonItem* saveButton;
 
+/// The buttons that undo and redo the edits to the model.
+@property UIBarButtonItem* undoButton;
+
 /// A pointer to a UIPopoverController which will contain the edit object menu.
 @property UIPopoverController* popOverController;
 
@@ -64,6 +76,12 @@ enum Segcontrol
 /// Will specifiy if a log file is being pushed so we do not have the save button enabled.
 @property bool isLogFileSaving;
 
+/// The loader of the model file currently being opened.  nil when no file is being opened.
+@property ModelLoader* modelLoader;
+
+/// The search for the feedback loops of the model that was just opened.  nil when no search is running.
+@property LoopFinder* loopFinder;
+
 -(id) init;
 -(void) reachabilityChanged:(NSNotification *)note;
 -(void) checkInternetConnection:(Reachability *)reachability;
@@ -74,6 +92,7 @@ enum Segcontrol
 -(void) viewDidLoad;
 -(void) reenableSaveButton;
 -(void) saveModel;
+-(void) findLoops;
 -(MFSideMenuContainerViewController *)menuContainerViewController;
 -(void) setupMenuBarButtonItems;
 -(UIBarButtonItem *) leftMenuBarButtonItem;
@@ -99,5 +118,6 @@ enum Segcontrol
 -(void) documentInteractionControllerDidDismissOpenInMenu: (UIDocumentInteractionController *) controller;
 -(void) documentInteractionController: (UIDocumentInteractionController *) controller willBeginSendingToApplication: (NSString *) application;
 -(void) menuChange;
+-(void) undoChange:(UISegmentedControl*) sender;
 -(NSString*)getMenuDetails;
 @end
@@ -29,6 +29,7 @@
 @synthesize loadButton                    = _loadButton;
 @synthesize saveSegControl                = _saveSegControl;
 @synthesize saveButton                    = _saveButton;
+@synthesize undoButton                    = _undoButton;
 @synthesize popOverController             = _popOverController;
 @synthesize selectedView                  = _selectedView;
 @synthesize modelView                     = _modelView;
@@ -36,6 +37,8 @@
 @synthesize documentInteractionController = _documentInteractionController;
 @synthesize logQueue                      = _logQueue;
 @synthesize isLogFileSaving               = _isLogFileSaving;
+@synthesize modelLoader                   = _modelLoader;
+@synthesize loopFinder                    = _loopFinder;
 
 /// Initializes the View Controller.
 /// Will create the views for all of the menu options.
@@ -45,6 +48,7 @@
     self = [super init];
     if (self) {
         self.modelView = [[ModelSectionView alloc]init];
+        [Model sharedModel].canvas = self.modelView;
         self.isLogFileSaving = NO;
         self.logQueue  = dispatch_queue_create(LOG_QUEUE, DISPATCH_QUEUE_SERIAL);
     }
@@ -113,13 +117,6 @@
 /// This method will redirect the user to Dropbox to open a model file.
 -(void)loadModel
 {
-//    NSArray * textFile =  [[file openFile] componentsSeparatedByString:@"\n"];
-//    
-//    // Read in the input file.
-//
-//    [[FileIO sharedFileIO] importModel:textFile];
-
-// Commented out so that I can use the IOS simulator.
     [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID: OPEN_FILE_REQUEST]];
     [[DBChooser defaultChooser] openChooserForLinkType:DBChooserLinkTypeDirect
                                     fromViewController:self completion:^(NSArray *results)
@@ -140,30 +137,41 @@
              }
              else
              {
-                 // Clear anything from a previous model.
-                 [[Model sharedModel] clearModel];
-              
                  // Log the event.
                  [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID: FILE_SELECTED andDetails:[myFile name]]];
                  
-                 // Set the tile of the nav controller.
-                 self.title = [myFile name];
-                 
-                 // Get the data from the url.
-                 NSData *thedata = [NSData dataWithContentsOfURL:[myFile link]];
-                 
-                 // Take a hash of the original file for logging purposes.
-                 NSData* hash = [FileIO sha1:thedata];
-                 [[Model sharedModel] setStartingHash:hash];
-
-                 // Parse the data into a string.
-                 NSString* stringOfData = [[NSString alloc] initWithData:thedata encoding:NSUTF8StringEncoding];
+                 // Stop opening any file that was previously selected but has not finished loading.
+                 [self.modelLoader cancel];
                  
-                 // Parse the string into an array separated by line breaks.
-                 NSArray * textFile =  [stringOfData componentsSeparatedByString:@"\n"];
-                 
-                 // Read in the input file.
-                 [[FileIO sharedFileIO] importModel:textFile];
+                 // Download, hash, and parse the file in the background so the model can still be used while it loads.
+                 NSString* fileName = [myFile name];
+                 self.title = [NSString stringWithFormat:LOADING_TITLE, fileName, 0];
+                 self.modelLoader = [[ModelLoader alloc] initWithURL:[myFile link]];
+                 [self.modelLoader loadWithProgress:^(int stage, float fraction) {
+                     // Only the parse stage reports progress within the stage.
+                     if(stage == LOAD_PARSE)
+                     {
+                         self.title = [NSString stringWithFormat:LOADING_TITLE, fileName, (int)(fraction * 100)];
+                     }
+                 } completion:^(ModelLoader* loader) {
+                     self.modelLoader = nil;
+                     
+                     // Set the tile of the nav controller.
+                     self.title = fileName;
+                     
+                     if(loader.graph)
+                     {
+                         // Replace the previous model with the newly opened one in a single step.
+                         [[Model sharedModel] clearModel];
+                         [[Model sharedModel] setStartingHash:loader.fileHash];
+                         [[Model sharedModel] loadGraph:loader.graph];
+                         [self findLoops];
+                     }
+                     else
+                     {
+                         [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID: FILE_LOAD_FAILED andDetails:fileName]];
+                     }
+                 }];
              }
          } else {
              // User canceled the action
@@ -172,6 +180,18 @@
      }];
 }
 
+/// Searches for the feedback loops of the model on screen in the background, and logs how many of each polarity it has.
+/// Any search still running for the previous model is cancelled.
+-(void) findLoops
+{
+    [self.loopFinder cancel];
+    self.loopFinder = [[LoopFinder alloc] initWithModel:[Model sharedModel]];
+    [self.loopFinder findLoopsWithProgress:nil completion:^(LoopFinder* finder) {
+        self.loopFinder = nil;
+        [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID: LOOPS_DISCOVERED andDetails:[finder summary]]];
+    }];
+}
+
 /// Will create a blank sheet so that the user can create a new model.
 -(void) newModel
 {
@@ -290,28 +310,29 @@
     // Log save button being pressed.
     [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID: SAVE_MODEL]];
     
-    NSURL* url = [[FileIO sharedFileIO] exportModel];
-    
-    if (url)
-    {
-        // Dismiss the document interaction controller if it happens to be open.  (If you have document interaction controller open and you try to show it again the app will crash).
-        [self.documentInteractionController dismissMenuAnimated:NO];
+    // The file is written from a snapshot in the background, so the model can be edited while it is exported.
+    [[FileIO sharedFileIO] exportModelWithCompletion:^(NSURL* url) {
+        if (url)
+        {
+            // Dismiss the document interaction controller if it happens to be open.  (If you have document interaction controller open and you try to show it again the app will crash).
+            [self.documentInteractionController dismissMenuAnimated:NO];
         
-        // Initialize Document Interaction Controller
-        self.documentInteractionController = [UIDocumentInteractionController interactionControllerWithURL:url];
+            // Initialize Document Interaction Controller
+            self.documentInteractionController = [UIDocumentInteractionController interactionControllerWithURL:url];
         
-        // Set delegate for Document Interaction Controller to self.
-        [self.documentInteractionController setDelegate:self];
-    
-        // Present Open In Menu
-        bool didDisplay = [self.documentInteractionController presentOpenInMenuFromBarButtonItem:[self.navigationItem.rightBarButtonItems objectAtIndex:1]animated:YES];
+            // Set delegate for Document Interaction Controller to self.
+            [self.documentInteractionController setDelegate:self];
         
-        // If the menu did not find apps that can open the file, display other options.
-        if(!didDisplay)
-        {
-            [self.documentInteractionController presentOptionsMenuFromBarButtonItem:[self.navigationItem.rightBarButtonItems objectAtIndex:1] animated:YES];
+            // Present Open In Menu
+            bool didDisplay = [self.documentInteractionController presentOpenInMenuFromBarButtonItem:[self.navigationItem.rightBarButtonItems objectAtIndex:1]animated:YES];
+        
+            // If the menu did not find apps that can open the file, display other options.
+            if(!didDisplay)
+            {
+                [self.documentInteractionController presentOptionsMenuFromBarButtonItem:[self.navigationItem.rightBarButtonItems objectAtIndex:1] animated:YES];
+            }
         }
-    }
+    }];
 }
 
 //================================================================================================================================
@@ -344,9 +365,12 @@
     self.saveButton.enabled = NO;
     self.saveSegControl.userInteractionEnabled = NO;
     
+    // Upload the file that was just exported, even if the model changes in the meantime.
+    ModelSnapshot* snapshot = [FileIO sharedFileIO].exportedSnapshot;
+    ModelVersion* exported  = [FileIO sharedFileIO].exportedVersion;
     dispatch_async(self.logQueue, ^{
         //NSLog(@"Starting job");
-        [[FileIO sharedFileIO] exportEventLogging];
+        [[FileIO sharedFileIO] exportEventLoggingForSnapshot:snapshot version:exported];
         //NSLog(@"Ending job");
         [self performSelectorOnMainThread:@selector(reenableSaveButton) withObject:nil waitUntilDone:NO];
     });
@@ -374,6 +398,25 @@
     [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID: ADD_OBJECT_CONTROL_CHANGED andDetails:details]];
 }
 
+/// Undoes or redoes the last edit to the model, depending on the button pressed.  The UndoHistory logs the step.
+/// @param sender the undo control.
+-(void) undoChange:(UISegmentedControl*) sender
+{
+    // Any open edit menu refers to the state before the step.
+    [self.popOverController dismissPopoverAnimated:NO];
+    
+    switch(sender.selectedSegmentIndex)
+    {
+        case UNDO_INDEX:
+            [[Model sharedModel].history undo];
+            break;
+            
+        case REDO_INDEX:
+            [[Model sharedModel].history redo];
+            break;
+    }
+}
+
 /// Used to get the name of the class that an update/edit menu is being created for.  Will be either Variable, Causal Link, or Loop.
 /// @return the name of the class that is being updated.
 -(NSString*)getMenuDetails
@@ -528,7 +571,24 @@
     // Convert segmented control to a bar button item
     UIBarButtonItem *controlsMenu = [[UIBarButtonItem alloc] initWithCustomView:self.controls];
     
-    return [[NSArray alloc] initWithObjects: controlsMenu, self.saveButton, self.takePictureButton, self.loadButton, self.createNewButton, nil];
+    //################################################################################################################
+    // Buttons to undo and redo edits to the model
+    UISegmentedControl* undoSegControl = [[UISegmentedControl alloc] initWithItems:[NSArray arrayWithObjects:
+                                                                                     UNDO_TITLE,
+                                                                                     REDO_TITLE,
+                                                                                     nil]];
+    
+    undoSegControl.momentary = TRUE;
+    undoSegControl.segmentedControlStyle = UISegmentedControlStyleBar; // this style allows me to update the tint color
+    [undoSegControl setTintColor: nil];
+    
+    // Register a selector callback when a button has been pressed.
+    [undoSegControl addTarget:self action:@selector(undoChange:) forControlEvents:UIControlEventValueChanged];
+    
+    // Convert segmented control to a bar button item
+    self.undoButton = [[UIBarButtonItem alloc] initWithCustomView:undoSegControl];
+    
+    return [[NSArray alloc] initWithObjects: controlsMenu, self.saveButton, self.takePictureButton, self.loadButton, self.createNewButton, self.undoButton, nil];
 }
 
 /// Callback for when the left menu button is pressed.
@@ -750,6 +810,11 @@
 /// Will save the changes made by the user related to the object they changed.
 -(void) saveChanges
 {
+    // The whole edit is a single undo step.
+    UndoHistory* history = [Model sharedModel].history;
+    [history beginStep];
+    [history willChangeComponent:[(id)self.selectedView parent]];
+    
     UIView* view = [[self.popOverController contentViewController] view];
     // Will iterate over all of the subviews in the popover controller.  (Should only be one)
     for(UIView* subview in view.subviews)
@@ -775,6 +840,7 @@
         }
     }
     
+    [history endStepWithDescID:EDIT_MENU_SAVED andObjectID:[self getSelectedViewIDNum]];
     [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID: EDIT_MENU_SAVED andObjectID:[self getSelectedViewIDNum]
                                                                 andDetails:[self getMenuDetails]]];
     
@@ -801,19 +867,25 @@
         // Will delete the object based on which type of object it is.
         else if (index == YES)
         {
+            // Deleting a component along with its links is a single undo step.
+            UndoHistory* history = [Model sharedModel].history;
+            [history beginStep];
             if([self.selectedView isKindOfClass:[VariableView class]])
             {
                 int idNum = [[Model sharedModel] deleteVariable:self.selectedView];
+                [history endStepWithDescID:VARIABLE_DELETED andObjectID:idNum];
                 [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID: VARIABLE_DELETED andObjectID:idNum]];
             }
             else if([self.selectedView isKindOfClass:[LoopView class]])
             {
                 int idNum = [[Model sharedModel] deleteLoop:self.selectedView];
+                [history endStepWithDescID:LOOP_DELETED andObjectID:idNum];
                 [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID: LOOP_DELETED andObjectID:idNum]];
             }
             else if ([self.selectedView isKindOfClass:[CausalLinkView class]])
             {
                 int idNum = [[Model sharedModel] deleteCausalLink:self.selectedView];
+                [history endStepWithDescID:CAUSAL_LINK_DELETED andObjectID:idNum];
                 [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID: CAUSAL_LINK_DELETED andObjectID:idNum]];
             }
         }
@@ -841,8 +913,10 @@
         else
         {
             [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID: NEW_MODEL]];
+            [self.loopFinder cancel];
+            self.loopFinder = nil;
             [[Model sharedModel] clearModel];
-            [[[Model sharedModel]getViewControllerView] setNeedsDisplay];
+            [[Model sharedModel].canvas setNeedsDisplay];
             self.title = DEFAULT_TITLE;
         }
     }
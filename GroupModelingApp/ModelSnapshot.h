@@ -0,0 +1,44 @@
+//
+//  ModelSnapshot.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class Model;
+
+/// A frozen copy of everything a Model writes to an exported mdl file.
+/// The variable maps and sketch records are the cached data of the components.  The data is immutable and shared with the live model until a component changes and caches new data, so taking a snapshot only renders the components that changed and copies pointers.
+/// A snapshot has to be taken on the main thread, but can then be exported, hashed and uploaded on any thread while the model keeps being edited.  Its properties are never changed once it has been taken.
+@interface ModelSnapshot : NSObject
+
+/// The first line of the variable map of each variable, in the order the variables were added.
+@property NSArray* varMaps;
+
+/// The sketch record of each component, in the order the components were added.
+@property NSArray* records;
+
+/// The id of each component, in the same order as the records.
+@property NSArray* ids;
+
+/// The simulation control parameters, empty if the model was created on the app.
+@property NSArray* controlParams;
+
+/// The default parameters, empty if the model was created on the app.
+@property NSString* defaultParams;
+
+/// The largest id handed out in the model.
+@property int largestIDNum;
+
+/// The hash of the file the model started from when the snapshot was taken.
+@property NSData* startingHash;
+
+/// Whether exporting the snapshot produces the empty model, whose hash is EMPTY_MODEL_HASH.
+@property bool isEmpty;
+
+-(id)initWithModel:(Model*)model;
+
+@end
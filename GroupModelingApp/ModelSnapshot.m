@@ -0,0 +1,91 @@
+//
+//  ModelSnapshot.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "Constants.h"
+#import "Model.h"
+#import "ModelSnapshot.h"
+
+@implementation ModelSnapshot
+
+@synthesize varMaps       = _varMaps;
+@synthesize records       = _records;
+@synthesize ids           = _ids;
+@synthesize controlParams = _controlParams;
+@synthesize defaultParams = _defaultParams;
+@synthesize largestIDNum  = _largestIDNum;
+@synthesize startingHash  = _startingHash;
+@synthesize isEmpty       = _isEmpty;
+
+/// Takes a snapshot of a model.  Must be called on the main thread, since the components that changed since the last snapshot are rendered from their views.
+/// @param model the model to take the snapshot of.
+/// @return a pointer to the newly created ModelSnapshot.
+-(id)initWithModel:(Model*)model
+{
+    self = [super init];
+    if(self)
+    {
+        // Every record is built in the same buffer.
+        RecordBuilder* builder = [[RecordBuilder alloc] init];
+        
+        // Only variables that changed since they were last exported need their map rebuilt.
+        NSMutableArray* varMaps = [[NSMutableArray alloc] initWithCapacity:model.variables.count];
+        for(Variable* var in model.variables)
+        {
+            if(!var.cachedVarMap)
+            {
+                [builder reset];
+                [var appendVarMapTo:builder];
+                var.cachedVarMap = [NSData dataWithBytes:[builder bytes] length:builder.length];
+            }
+            [varMaps addObject:var.cachedVarMap];
+        }
+        
+        // Only components that changed since they were last exported need their record rebuilt.
+        NSMutableArray* records = [[NSMutableArray alloc] initWithCapacity:model.components.count];
+        NSMutableArray* ids     = [[NSMutableArray alloc] initWithCapacity:model.components.count];
+        for(Component* compo in model.components)
+        {
+            if(!compo.cachedRecord)
+            {
+                [builder reset];
+                if([compo isMemberOfClass:[Loop class]])
+                {
+                    [(Loop*)compo appendLoopOutputTo:builder];
+                }
+                else if([compo isMemberOfClass:[Variable class]])
+                {
+                    [(Variable*)compo appendVariableOutputTo:builder];
+                }
+                else if([compo isMemberOfClass:[CausalLink class]])
+                {
+                    [(CausalLink*)compo appendCausalLinkOutputTo:builder];
+                }
+                compo.cachedRecord = [NSData dataWithBytes:[builder bytes] length:builder.length];
+            }
+            [records addObject:compo.cachedRecord];
+            [ids addObject:[NSNumber numberWithInt:compo.idNum]];
+        }
+        
+        self.varMaps       = varMaps;
+        self.records       = records;
+        self.ids           = ids;
+        self.controlParams = [model.controlParams.params copy];
+        self.defaultParams = [model.defaultParams.params copy];
+        self.largestIDNum  = [model.idAllocator largestID];
+        self.startingHash  = model.startingHash;
+        
+        // The model is empty when there are no components, the default parameters and control parameters have not changed, and no ids have been used.
+        self.isEmpty = records.count == 0 &&
+                       self.largestIDNum == 0 &&
+                       ([self.defaultParams isEqualToString:@""] || [self.defaultParams isEqualToString:DEFAULT_PARAMS]) &&
+                       (self.controlParams.count == 0 || [[self.controlParams componentsJoinedByString:@"\n"] isEqualToString:CONTROL_PARAMS]);
+    }
+    return self;
+}
+
+@end
@@ -0,0 +1,37 @@
+//
+//  ModelTransaction.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/// The edits collected by the Model between beginTransaction and commitTransaction:.
+/// Instead of adding or removing a view and redisplaying for every component, the views are kept here and updated in a single pass when the transaction is committed.  The ids of the components are kept so the whole transaction is logged as one event.
+@interface ModelTransaction : NSObject
+
+/// The number of beginTransaction calls that have not been committed yet.  Only the outermost commit applies the transaction.
+@property int depth;
+
+/// The ids of the components added.
+@property NSMutableIndexSet* addedIDs;
+
+/// The ids of the components changed.
+@property NSMutableIndexSet* changedIDs;
+
+/// The ids of the components removed.
+@property NSMutableIndexSet* removedIDs;
+
+/// The components whose views are added to the canvas on commit.
+@property NSMutableArray* displayed;
+
+/// The views removed from the canvas on commit.
+@property NSMutableArray* removedViews;
+
+-(id)init;
+-(NSString*) detailsForAction:(NSString*)action;
++(NSString*) stringFromIDs:(NSIndexSet*)ids;
+
+@end
@@ -0,0 +1,88 @@
+//
+//  ModelTransaction.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "Constants.h"
+#import "ModelTransaction.h"
+
+@implementation ModelTransaction
+
+@synthesize depth        = _depth;
+@synthesize addedIDs     = _addedIDs;
+@synthesize changedIDs   = _changedIDs;
+@synthesize removedIDs   = _removedIDs;
+@synthesize displayed    = _displayed;
+@synthesize removedViews = _removedViews;
+
+/// Initializes an empty transaction.
+/// @return a pointer to the newly created ModelTransaction.
+-(id)init
+{
+    self = [super init];
+    if(self)
+    {
+        self.depth        = 0;
+        self.addedIDs     = [[NSMutableIndexSet alloc] init];
+        self.changedIDs   = [[NSMutableIndexSet alloc] init];
+        self.removedIDs   = [[NSMutableIndexSet alloc] init];
+        self.displayed    = [[NSMutableArray alloc] init];
+        self.removedViews = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+/// Constructs the details of the single event logged for the transaction.
+/// A component added or removed in the transaction is only counted as added or removed, even if it was also changed.
+/// @param action what the transaction did.
+/// @return the counts of the components added, changed and removed, followed by their ids.
+-(NSString*) detailsForAction:(NSString*)action
+{
+    NSMutableIndexSet* changed = [self.changedIDs mutableCopy];
+    [changed removeIndexes:self.addedIDs];
+    [changed removeIndexes:self.removedIDs];
+    
+    NSMutableString* details = [[NSMutableString alloc] initWithFormat:TRANSACTION_COUNTS, action,
+                                (int)self.addedIDs.count, (int)changed.count, (int)self.removedIDs.count];
+    if(self.addedIDs.count > 0)
+    {
+        [details appendFormat:TRANSACTION_IDS, @"Added", [ModelTransaction stringFromIDs:self.addedIDs]];
+    }
+    if(changed.count > 0)
+    {
+        [details appendFormat:TRANSACTION_IDS, @"Changed", [ModelTransaction stringFromIDs:changed]];
+    }
+    if(self.removedIDs.count > 0)
+    {
+        [details appendFormat:TRANSACTION_IDS, @"Removed", [ModelTransaction stringFromIDs:self.removedIDs]];
+    }
+    return details;
+}
+
+/// Lists a set of ids as comma separated ranges, so a selection of hundreds of components with consecutive ids stays short.
+/// @param ids the ids to list.
+/// @return the ids, ex. 3-7,12.
++(NSString*) stringFromIDs:(NSIndexSet*)ids
+{
+    NSMutableString* list = [[NSMutableString alloc] init];
+    [ids enumerateRangesUsingBlock:^(NSRange range, BOOL* stop) {
+        if(list.length > 0)
+        {
+            [list appendString:@","];
+        }
+        if(range.length == 1)
+        {
+            [list appendFormat:@"%lu", (unsigned long)range.location];
+        }
+        else
+        {
+            [list appendFormat:@"%lu-%lu", (unsigned long)range.location, (unsigned long)NSMaxRange(range) - 1];
+        }
+    }];
+    return list;
+}
+
+@end
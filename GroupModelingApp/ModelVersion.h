@@ -0,0 +1,36 @@
+//
+//  ModelVersion.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/// The structure of an exported mdl file, split into the lines before the sketch records, the record of each component by id, and the lines after the records.
+/// The exported file is exactly the prefix, every record in order, and the trailer, joined by newlines.
+/// Two versions can be compared to create a delta that lists only the components that were added, removed, or changed, which the analysis scripts apply to the earlier file to get the later one.
+@interface ModelVersion : NSObject
+
+/// The sha1 hash of the exported file.
+@property NSData* fileHash;
+
+/// Every line before the first record.  The variable maps, control parameters, and sketch header.
+@property NSData* prefix;
+
+/// The ids of the components in the order their records were written.
+@property NSMutableArray* ids;
+
+/// The record of each component keyed by id.  Shares the cached records of the components, so it is not a copy of the file.
+@property NSMutableDictionary* records;
+
+/// Every line after the last record.  The largest id and any padding of an empty model.
+@property NSData* trailer;
+
+-(id)init;
+-(void) addRecord:(NSData*)record forID:(int)idNum;
+-(NSData*) fileData;
+-(NSData*) deltaFromVersion:(ModelVersion*)base;
+
+@end
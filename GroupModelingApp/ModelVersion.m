@@ -0,0 +1,158 @@
+//
+//  ModelVersion.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "Constants.h"
+#import "FileIO.h"
+#import "ModelVersion.h"
+
+/// Appends a line of text to a delta.
+/// @param delta the delta being written.
+/// @param line the line, without its newline.
+static void appendDeltaLine(NSMutableData* delta, NSString* line)
+{
+    [delta appendData:[line dataUsingEncoding:NSUTF8StringEncoding]];
+    [delta appendBytes:"\n" length:1];
+}
+
+/// Appends a block of bytes to a delta as the operation and the number of bytes on one line, followed by the bytes and a newline.
+/// The length is given so that blocks holding newlines of their own, like the record of a Loop, are read back exactly.
+/// @param delta the delta being written.
+/// @param operation the character marking what the block is.
+/// @param block the bytes of the block.
+static void appendDeltaBlock(NSMutableData* delta, char operation, NSData* block)
+{
+    appendDeltaLine(delta, [NSString stringWithFormat:@"%c%lu", operation, (unsigned long)block.length]);
+    [delta appendData:block];
+    [delta appendBytes:"\n" length:1];
+}
+
+@implementation ModelVersion
+
+@synthesize fileHash = _fileHash;
+@synthesize prefix   = _prefix;
+@synthesize ids      = _ids;
+@synthesize records  = _records;
+@synthesize trailer  = _trailer;
+
+/// Initializes an empty ModelVersion.
+/// @return a pointer to the newly created ModelVersion.
+-(id)init
+{
+    self = [super init];
+    if(self)
+    {
+        self.fileHash = [NSData data];
+        self.prefix   = [NSData data];
+        self.ids      = [[NSMutableArray alloc] init];
+        self.records  = [[NSMutableDictionary alloc] init];
+        self.trailer  = [NSData data];
+    }
+    return self;
+}
+
+/// Adds the record of a component to the end of the version.
+/// @param record the bytes of the sketch record of the component as written to the file.
+/// @param idNum the id of the component.
+-(void) addRecord:(NSData*)record forID:(int)idNum
+{
+    NSNumber* key = [NSNumber numberWithInt:idNum];
+    [self.ids addObject:key];
+    [self.records setObject:record forKey:key];
+}
+
+/// Rebuilds the exported file from the prefix, the records and the trailer.
+/// Used by the upload, since the file on disk may already have been replaced by a later export.
+/// @return the contents of the exported file.
+-(NSData*) fileData
+{
+    NSMutableData* file = [[NSMutableData alloc] initWithData:self.prefix];
+    for(NSNumber* key in self.ids)
+    {
+        [file appendBytes:"\n" length:1];
+        [file appendData:[self.records objectForKey:key]];
+    }
+    [file appendBytes:"\n" length:1];
+    [file appendData:self.trailer];
+    return file;
+}
+
+/// Creates the delta that turns the file of an earlier version into the file of this version.
+/// The delta starts with DELTA_HEADER, the base64 hash of the earlier file, and the base64 hash of this file, one per line.  Each entry after that is one of:
+/// - DELTA_PREFIX and a block with the new prefix, only when it changed.
+/// - DELTA_REMOVE and the id of a component that was deleted.
+/// - DELTA_CHANGE and a block with the new record of a component, which replaces the record with the same id in place.
+/// - DELTA_ADD and a block with the record of a new component, which is added after every other record.
+/// - DELTA_TRAILER and a block with the new trailer, only when it changed.
+/// @see PythonScripts/reconstructModel.py for the script that applies a delta.
+/// @param base the version the server already holds.
+/// @return the delta, nil if the records were reordered in a way a delta cannot express.
+-(NSData*) deltaFromVersion:(ModelVersion*)base
+{
+    // The delta can only keep the surviving records in their old order and add new ones at the end, which is also how the Model orders its components.
+    NSMutableArray* expected = [[NSMutableArray alloc] initWithCapacity:self.ids.count];
+    for(NSNumber* key in base.ids)
+    {
+        if([self.records objectForKey:key])
+        {
+            [expected addObject:key];
+        }
+    }
+    for(NSNumber* key in self.ids)
+    {
+        if(![base.records objectForKey:key])
+        {
+            [expected addObject:key];
+        }
+    }
+    if(![expected isEqualToArray:self.ids])
+    {
+        return nil;
+    }
+    
+    NSMutableData* delta = [[NSMutableData alloc] init];
+    appendDeltaLine(delta, DELTA_HEADER);
+    appendDeltaLine(delta, [FileIO base64forData:base.fileHash]);
+    appendDeltaLine(delta, [FileIO base64forData:self.fileHash]);
+    
+    if(![self.prefix isEqualToData:base.prefix])
+    {
+        appendDeltaBlock(delta, DELTA_PREFIX, self.prefix);
+    }
+    
+    for(NSNumber* key in base.ids)
+    {
+        if(![self.records objectForKey:key])
+        {
+            appendDeltaLine(delta, [NSString stringWithFormat:@"%c%d", DELTA_REMOVE, [key intValue]]);
+        }
+    }
+    
+    for(NSNumber* key in self.ids)
+    {
+        NSData* record     = [self.records objectForKey:key];
+        NSData* baseRecord = [base.records objectForKey:key];
+        if(!baseRecord)
+        {
+            appendDeltaBlock(delta, DELTA_ADD, record);
+        }
+        // Components that have not changed since the base still share the same cached record.
+        else if(record != baseRecord && ![record isEqualToData:baseRecord])
+        {
+            appendDeltaBlock(delta, DELTA_CHANGE, record);
+        }
+    }
+    
+    if(![self.trailer isEqualToData:base.trailer])
+    {
+        appendDeltaBlock(delta, DELTA_TRAILER, self.trailer);
+    }
+    
+    return delta;
+}
+
+@end
@@ -0,0 +1,31 @@
+//
+//  RecordBuilder.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/// A reusable byte buffer that a single line of a Vensim mdl file is built up in.
+/// Integers, names, and the fixed pieces of a record are encoded straight into the buffer as UTF-8, so building a line does not create any intermediate strings.
+/// A single builder is meant to be reset and reused for every line of an export, so the buffer only grows to the size of the longest line.
+@interface RecordBuilder : NSObject
+
+/// The storage of the buffer.  Its length is the capacity of the buffer, not the length of the line.
+@property NSMutableData* storage;
+
+/// The number of bytes in the line being built.
+@property NSUInteger length;
+
+-(id)init;
+-(void)reset;
+-(const void*)bytes;
+-(void)appendInt:(int)value;
+-(void)appendField:(int)value;
+-(void)appendLiteral:(const char*)literal;
+-(void)appendString:(NSString*)string;
+-(NSString*)string;
+
+@end
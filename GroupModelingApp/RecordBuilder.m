@@ -0,0 +1,132 @@
+//
+//  RecordBuilder.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "Constants.h"
+#import "RecordBuilder.h"
+
+@implementation RecordBuilder
+
+@synthesize storage = _storage;
+@synthesize length  = _length;
+
+/// Initializes an empty RecordBuilder.
+/// @return a pointer to the newly created RecordBuilder.
+-(id)init
+{
+    self = [super init];
+    if(self)
+    {
+        self.storage = [[NSMutableData alloc] initWithLength:RECORD_BUILDER_CAPACITY];
+        self.length  = 0;
+    }
+    return self;
+}
+
+/// Empties the line so that the next one can be built.  The storage is kept.
+-(void)reset
+{
+    self.length = 0;
+}
+
+/// Gets the bytes of the line being built.  Only valid until the next append.
+/// @return a pointer to the first byte of the line.
+-(const void*)bytes
+{
+    return self.storage.bytes;
+}
+
+/// Makes sure there is room in the storage for more bytes, doubling it when needed.
+/// @param count the number of bytes about to be appended.
+/// @return a pointer to where the bytes should be written.
+-(char*)reserve:(NSUInteger)count
+{
+    NSUInteger capacity = self.storage.length;
+    if(self.length + count > capacity)
+    {
+        while(self.length + count > capacity)
+        {
+            capacity *= 2;
+        }
+        [self.storage setLength:capacity];
+    }
+    return (char*)self.storage.mutableBytes + self.length;
+}
+
+/// Appends an integer in decimal.
+/// @param value the integer to append.
+-(void)appendInt:(int)value
+{
+    // Enough room for every digit of the smallest int and its sign.
+    char digits[12];
+    int count = 0;
+    long long remaining = value;
+    bool negative = remaining < 0;
+    if(negative)
+    {
+        remaining = -remaining;
+    }
+    do
+    {
+        digits[count++] = '0' + (char)(remaining % 10);
+        remaining /= 10;
+    } while(remaining > 0);
+    
+    char* output = [self reserve:count + negative];
+    if(negative)
+    {
+        *output++ = '-';
+    }
+    while(count > 0)
+    {
+        *output++ = digits[--count];
+    }
+    self.length = output - (char*)self.storage.mutableBytes;
+}
+
+/// Appends a comma followed by an integer, the form of every field of a record after the first.
+/// @param value the integer to append.
+-(void)appendField:(int)value
+{
+    *[self reserve:1] = ',';
+    self.length += 1;
+    [self appendInt:value];
+}
+
+/// Appends a null terminated C string.
+/// @param literal the string to append.
+-(void)appendLiteral:(const char*)literal
+{
+    NSUInteger count = strlen(literal);
+    memcpy([self reserve:count], literal, count);
+    self.length += count;
+}
+
+/// Appends a string encoded as UTF-8.  The string is encoded directly into the buffer.
+/// @param string the string to append.
+-(void)appendString:(NSString*)string
+{
+    NSUInteger maxCount = [string maximumLengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    NSUInteger usedCount = 0;
+    [string getBytes:[self reserve:maxCount]
+           maxLength:maxCount
+          usedLength:&usedCount
+            encoding:NSUTF8StringEncoding
+             options:0
+               range:NSMakeRange(0, string.length)
+      remainingRange:NULL];
+    self.length += usedCount;
+}
+
+/// Creates a string of the line that has been built.
+/// @return the line as a string.
+-(NSString*)string
+{
+    return [[NSString alloc] initWithBytes:self.storage.bytes length:self.length encoding:NSUTF8StringEncoding];
+}
+
+@end
@@ -0,0 +1,26 @@
+//
+//  RecordScanner.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <stdbool.h>
+
+/// A cursor over a single comma separated sketch record of a Vensim mdl file.
+/// Fields are decoded directly from the bytes of the line so that no intermediate strings or arrays are created while reading a record.
+/// A single scanner is meant to be reset and reused for every line of the file.
+@interface RecordScanner : NSObject
+
+-(id)initWithBytes:(const char*)bytes length:(NSUInteger)length;
+-(void)resetWithBytes:(const char*)bytes length:(NSUInteger)length;
+-(bool)moveToField:(int)index;
+-(int)intAtField:(int)index;
+-(NSString*)stringAtField:(int)index;
+-(bool)colorAtField:(int)index red:(int*)red green:(int*)green blue:(int*)blue;
+-(int)handleXAtField:(int)index;
+-(int)handleYAtField:(int)index;
+
+@end
@@ -0,0 +1,211 @@
+//
+//  RecordScanner.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <string.h>
+#import "RecordScanner.h"
+
+/// Reads an integer the same way NSString integerValue does. Leading whitespace and a sign are allowed and reading stops at the first non-digit.
+/// @param bytes the bytes to read from.
+/// @param start the index of the first byte to read.
+/// @param end the index one past the last byte that may be read.
+/// @param next will be set to the index of the first byte after the integer, may be NULL.
+/// @return the integer that was read, 0 if there was no integer.
+static int scanInt(const char* bytes, NSUInteger start, NSUInteger end, NSUInteger* next)
+{
+    NSUInteger i = start;
+    int sign  = 1;
+    int value = 0;
+    
+    while(i < end && (bytes[i] == ' ' || bytes[i] == '\t'))
+    {
+        ++i;
+    }
+    if(i < end && (bytes[i] == '-' || bytes[i] == '+'))
+    {
+        sign = (bytes[i] == '-') ? -1 : 1;
+        ++i;
+    }
+    while(i < end && bytes[i] >= '0' && bytes[i] <= '9')
+    {
+        value = value * 10 + (bytes[i] - '0');
+        ++i;
+    }
+    if(next)
+    {
+        *next = i;
+    }
+    return sign * value;
+}
+
+@implementation RecordScanner
+{
+    const char* _bytes;      // The bytes of the record being read.  Not owned by the scanner.
+    NSUInteger  _length;     // The number of bytes in the record.
+    int         _fieldIndex; // The index of the field the scanner is positioned on.
+    NSUInteger  _fieldStart; // The index of the first byte of the current field.
+    NSUInteger  _fieldEnd;   // The index one past the last byte of the current field.
+}
+
+/// Initializes the RecordScanner.
+/// @param bytes a pointer to the first byte of the record. The bytes must remain valid while the scanner is in use.
+/// @param length the number of bytes in the record.
+/// @return a pointer to the newly created RecordScanner.
+-(id)initWithBytes:(const char*)bytes length:(NSUInteger)length
+{
+    self = [super init];
+    if(self)
+    {
+        [self resetWithBytes:bytes length:length];
+    }
+    return self;
+}
+
+/// Points the scanner at a new record and positions it on the first field.
+/// @param bytes a pointer to the first byte of the record. The bytes must remain valid while the scanner is in use.
+/// @param length the number of bytes in the record.
+-(void)resetWithBytes:(const char*)bytes length:(NSUInteger)length
+{
+    _bytes      = bytes;
+    _length     = length;
+    _fieldIndex = 0;
+    _fieldStart = 0;
+    _fieldEnd   = [self findFieldEnd:0];
+}
+
+/// Finds where a field ends.  Names containing commas are quoted by Vensim, so a comma inside of quotes does not end the field.
+/// @param start the index of the first byte of the field.
+/// @return the index of the comma ending the field, or the length of the record for the last field.
+-(NSUInteger)findFieldEnd:(NSUInteger)start
+{
+    NSUInteger i = start;
+    
+    // Skip over a quoted name, including any escaped characters within it.
+    if(i < _length && _bytes[i] == '"')
+    {
+        for(++i; i < _length && _bytes[i] != '"'; ++i)
+        {
+            if(_bytes[i] == '\\')
+            {
+                ++i;
+            }
+        }
+    }
+    
+    if(i >= _length)
+    {
+        return _length;
+    }
+    
+    const char* comma = memchr(_bytes + i, ',', _length - i);
+    return comma ? (NSUInteger)(comma - _bytes) : _length;
+}
+
+/// Positions the scanner on a field.  Fields are meant to be read in increasing order, reading an earlier field will rescan the record from the start.
+/// @param index the index of the field, as if the record had been split on commas.
+/// @return true if the record has a field at index.
+-(bool)moveToField:(int)index
+{
+    if(index < _fieldIndex)
+    {
+        _fieldIndex = 0;
+        _fieldStart = 0;
+        _fieldEnd   = [self findFieldEnd:0];
+    }
+    
+    while(_fieldIndex < index)
+    {
+        if(_fieldEnd >= _length)
+        {
+            return false;
+        }
+        _fieldStart = _fieldEnd + 1;
+        _fieldEnd   = [self findFieldEnd:_fieldStart];
+        ++_fieldIndex;
+    }
+    return true;
+}
+
+/// Reads a field as an integer.
+/// @param index the index of the field.
+/// @return the integer value of the field, 0 if the field does not exist or is not a number.
+-(int)intAtField:(int)index
+{
+    if(![self moveToField:index])
+    {
+        return 0;
+    }
+    return scanInt(_bytes, _fieldStart, _fieldEnd, NULL);
+}
+
+/// Reads a field as a string.  This is the only read that creates an object and should be reserved for names.
+/// @param index the index of the field.
+/// @return the field decoded as UTF-8, an empty string if the field does not exist.
+-(NSString*)stringAtField:(int)index
+{
+    if(![self moveToField:index])
+    {
+        return @"";
+    }
+    NSString* string = [[NSString alloc] initWithBytes:_bytes + _fieldStart
+                                                length:_fieldEnd - _fieldStart
+                                              encoding:NSUTF8StringEncoding];
+    return (string) ? string : @"";
+}
+
+/// Reads a color field stored in the format R-G-B.  The Vensim default color is stored as -1--1--1.
+/// @param index the index of the field.
+/// @param red will be set to the red value.
+/// @param green will be set to the green value.
+/// @param blue will be set to the blue value.
+/// @return true if the field held a color, false if it held the default color or could not be read.
+-(bool)colorAtField:(int)index red:(int*)red green:(int*)green blue:(int*)blue
+{
+    *red = *green = *blue = 0;
+    if(![self moveToField:index])
+    {
+        return false;
+    }
+    
+    NSUInteger next = _fieldStart;
+    *red = scanInt(_bytes, next, _fieldEnd, &next);
+    if(next >= _fieldEnd || _bytes[next] != '-')
+    {
+        return false;
+    }
+    *green = scanInt(_bytes, next + 1, _fieldEnd, &next);
+    if(next >= _fieldEnd || _bytes[next] != '-')
+    {
+        return false;
+    }
+    *blue = scanInt(_bytes, next + 1, _fieldEnd, &next);
+    
+    return *red >= 0 && *green >= 0 && *blue >= 0;
+}
+
+/// Reads the x coordinate of a causal link handle, which is stored in a format like: 1|(###
+/// @param index the index of the field.
+/// @return the x coordinate, 0 if the field could not be read.
+-(int)handleXAtField:(int)index
+{
+    if(![self moveToField:index])
+    {
+        return 0;
+    }
+    const char* paren = memchr(_bytes + _fieldStart, '(', _fieldEnd - _fieldStart);
+    return paren ? scanInt(_bytes, (NSUInteger)(paren - _bytes) + 1, _fieldEnd, NULL) : 0;
+}
+
+/// Reads the y coordinate of a causal link handle, which is stored in a format like: ###)|
+/// @param index the index of the field.
+/// @return the y coordinate, 0 if the field could not be read.
+-(int)handleYAtField:(int)index
+{
+    return [self intAtField:index];
+}
+
+@end
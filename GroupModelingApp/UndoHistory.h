@@ -0,0 +1,52 @@
+//
+//  UndoHistory.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "Component.h"
+
+@class Model;
+
+/// The undo and redo stacks of a Model.
+/// Each step is a delta holding the record of every component it touched before and after the edit, so undoing or redoing a step only touches those components.
+/// A step is opened with beginStep, the components about to change are declared with willChangeComponent:, and the step is closed with endStepWithDescID:andObjectID:.  Components added or removed in between are picked up by the Model.
+/// The steps are kept as bytes, and the oldest steps are dropped once the stacks hold more than byteBudget bytes.
+@interface UndoHistory : NSObject
+
+/// The model the steps are applied to.  Weak since the model holds on to its history.
+@property (weak) Model* model;
+
+/// The number of bytes the undo and redo stacks can hold together.
+@property NSUInteger byteBudget;
+
+/// The number of bytes held by the undo and redo stacks.
+@property NSUInteger byteCount;
+
+/// The steps that can be undone, the most recent last.
+@property NSMutableArray* undoSteps;
+
+/// The steps that can be redone, the most recently undone last.
+@property NSMutableArray* redoSteps;
+
+/// The record of every component touched by the open step as it was before the step, keyed by id.  NSNull for a component added by the step.  nil when no step is open.
+@property NSMutableDictionary* openRecords;
+
+/// The ids of the components touched by the open step, in the order they were touched.
+@property NSMutableArray* openIDs;
+
+-(id)initWithModel:(Model*)model;
+-(void) beginStep;
+-(void) willChangeComponent:(Component*)compo;
+-(void) componentAdded:(Component*)compo;
+-(void) endStepWithDescID:(int)descID andObjectID:(int)idNum;
+-(bool) canUndo;
+-(bool) canRedo;
+-(bool) undo;
+-(bool) redo;
+-(void) clear;
+
+@end
@@ -0,0 +1,384 @@
+//
+//  UndoHistory.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "Constants.h"
+#import "EventLogger.h"
+#import "Model.h"
+#import "ModelArchive.h"
+#import "UndoHistory.h"
+
+/// Every step starts with the event that made the edit, so undoing or redoing it can be logged against the same object.
+struct UndoStepHeader
+{
+    int32_t descID;
+    int32_t objectID;
+};
+
+/// One component touched by a step is stored as its id, followed by its record before and after the step.
+/// Each record is its length and the bytes written by ModelArchive appendRecord:toData:.  A length of 0 means the component did not exist.
+struct UndoEntryHeader
+{
+    int32_t  idNum;
+    uint32_t beforeLength;
+};
+
+/// Creates the record of the current state of a component.
+/// @param compo the CausalLink, Variable or Loop.
+/// @return the record, nil if the component is not part of the model.
+static ComponentRecord* recordOfComponent(Component* compo)
+{
+    if([compo isMemberOfClass:[Variable class]])
+    {
+        return [(Variable*)compo createRecord];
+    }
+    else if([compo isMemberOfClass:[CausalLink class]])
+    {
+        return [(CausalLink*)compo createRecord];
+    }
+    else if([compo isMemberOfClass:[Loop class]])
+    {
+        return [(Loop*)compo createRecord];
+    }
+    return nil;
+}
+
+/// Encodes a record the way it is stored in a step.
+/// @param record the record, nil or NSNull if the component did not exist.
+/// @return the bytes of the record, empty if there is no record.
+static NSData* encodeRecord(id record)
+{
+    NSMutableData* data = [[NSMutableData alloc] init];
+    if([record isKindOfClass:[ComponentRecord class]])
+    {
+        [ModelArchive appendRecord:record toData:data];
+    }
+    return data;
+}
+
+@implementation UndoHistory
+
+@synthesize model       = _model;
+@synthesize byteBudget  = _byteBudget;
+@synthesize byteCount   = _byteCount;
+@synthesize undoSteps   = _undoSteps;
+@synthesize redoSteps   = _redoSteps;
+@synthesize openRecords = _openRecords;
+@synthesize openIDs     = _openIDs;
+
+/// Initializes an empty history for a model.
+/// @param model the model the steps are applied to.
+/// @return a pointer to the newly created UndoHistory.
+-(id)initWithModel:(Model*)model
+{
+    self = [super init];
+    if(self)
+    {
+        self.model       = model;
+        self.byteBudget  = UNDO_BYTE_BUDGET;
+        self.byteCount   = 0;
+        self.undoSteps   = [[NSMutableArray alloc] init];
+        self.redoSteps   = [[NSMutableArray alloc] init];
+        self.openRecords = nil;
+        self.openIDs     = nil;
+    }
+    return self;
+}
+
+/// Opens a step.  Every component added, removed or declared with willChangeComponent: until the step is ended is part of the step.
+/// If a step is already open, for example because a gesture was interrupted, the edits are added to it instead.
+-(void) beginStep
+{
+    if(!self.openRecords)
+    {
+        self.openRecords = [[NSMutableDictionary alloc] init];
+        self.openIDs     = [[NSMutableArray alloc] init];
+    }
+}
+
+/// Keeps the current state of a component that is about to change, unless the open step already holds it.
+/// Changing a Variable also changes the CausalLinks touching it, so their states are kept as well.
+/// @param compo the CausalLink, Variable or Loop about to change.
+-(void) willChangeComponent:(Component*)compo
+{
+    if(!self.openRecords || compo == nil)
+    {
+        return;
+    }
+    
+    NSNumber* key = [NSNumber numberWithInt:compo.idNum];
+    if(![self.openRecords objectForKey:key])
+    {
+        ComponentRecord* record = recordOfComponent(compo);
+        if(record)
+        {
+            [self.openRecords setObject:record forKey:key];
+            [self.openIDs addObject:key];
+        }
+    }
+    
+    if([compo isMemberOfClass:[Variable class]])
+    {
+        for(Component* link in [(Variable*)compo indegreeLinks])
+        {
+            [self willChangeComponent:link];
+        }
+        for(Component* link in [(Variable*)compo outdegreeLinks])
+        {
+            [self willChangeComponent:link];
+        }
+    }
+}
+
+/// Records that a component did not exist before the open step.
+/// @param compo the CausalLink, Variable or Loop that was added.
+-(void) componentAdded:(Component*)compo
+{
+    if(!self.openRecords)
+    {
+        return;
+    }
+    
+    NSNumber* key = [NSNumber numberWithInt:compo.idNum];
+    if(![self.openRecords objectForKey:key])
+    {
+        [self.openRecords setObject:[NSNull null] forKey:key];
+        [self.openIDs addObject:key];
+    }
+}
+
+/// Closes the open step and pushes it on the undo stack, unless it did not change anything.
+/// Components whose record is the same before and after the step are left out, so a tap that did not move a variable adds no step.
+/// @param descID the event that made the edit.
+/// @param idNum the id of the object of the event, the same as the one logged for the event.
+-(void) endStepWithDescID:(int)descID andObjectID:(int)idNum
+{
+    if(!self.openRecords)
+    {
+        return;
+    }
+    
+    struct UndoStepHeader header = { descID, idNum };
+    NSMutableData* step = [[NSMutableData alloc] initWithBytes:&header length:sizeof(header)];
+    bool changed = NO;
+    for(NSNumber* key in self.openIDs)
+    {
+        NSData* before = encodeRecord([self.openRecords objectForKey:key]);
+        NSData* after  = encodeRecord(recordOfComponent([self.model getComponent:[key intValue]]));
+        if([before isEqualToData:after])
+        {
+            continue;
+        }
+        
+        struct UndoEntryHeader entry = { [key intValue], (uint32_t)before.length };
+        uint32_t afterLength = (uint32_t)after.length;
+        [step appendBytes:&entry length:sizeof(entry)];
+        [step appendData:before];
+        [step appendBytes:&afterLength length:sizeof(afterLength)];
+        [step appendData:after];
+        changed = YES;
+    }
+    self.openRecords = nil;
+    self.openIDs     = nil;
+    
+    if(!changed)
+    {
+        return;
+    }
+    
+    // A new edit replaces whatever was undone.
+    for(NSData* redo in self.redoSteps)
+    {
+        self.byteCount -= redo.length;
+    }
+    [self.redoSteps removeAllObjects];
+    
+    [self.undoSteps addObject:step];
+    self.byteCount += step.length;
+    
+    // Drop the oldest steps until the history fits in the budget, but always keep the step just made.
+    while(self.byteCount > self.byteBudget && self.undoSteps.count > 1)
+    {
+        self.byteCount -= [[self.undoSteps objectAtIndex:0] length];
+        [self.undoSteps removeObjectAtIndex:0];
+    }
+}
+
+/// Whether there is a step to undo.
+/// @return true if undo would change the model.
+-(bool) canUndo
+{
+    return self.undoSteps.count > 0 && !self.openRecords;
+}
+
+/// Whether there is a step to redo.
+/// @return true if redo would change the model.
+-(bool) canRedo
+{
+    return self.redoSteps.count > 0 && !self.openRecords;
+}
+
+/// Puts every component touched by the most recent step back the way it was before the step, and logs UNDO_STEP against the object of the step.
+/// @return true if a step was undone.
+-(bool) undo
+{
+    if(![self canUndo])
+    {
+        return false;
+    }
+    
+    NSData* step = [self.undoSteps lastObject];
+    [self.undoSteps removeLastObject];
+    [self.redoSteps addObject:step];
+    [self applyStep:step useAfter:NO descID:UNDO_STEP];
+    return true;
+}
+
+/// Makes the most recently undone step again, and logs REDO_STEP against the object of the step.
+/// @return true if a step was redone.
+-(bool) redo
+{
+    if(![self canRedo])
+    {
+        return false;
+    }
+    
+    NSData* step = [self.redoSteps lastObject];
+    [self.redoSteps removeLastObject];
+    [self.undoSteps addObject:step];
+    [self applyStep:step useAfter:YES descID:REDO_STEP];
+    return true;
+}
+
+/// Sets every component touched by a step to its record from one side of the step, in a single transaction of the model.
+/// Components that exist on both sides of the step are updated in place, so they keep their views and their place in the order of the model, and the exported file and the next delta are the same as before the step.
+/// Links are removed first and created last, so that the Variables they connect exist and are in their final place.
+/// @param step the step to apply.
+/// @param useAfter true to apply the records after the step, false for the records before it.
+/// @param descID the event to log, UNDO_STEP or REDO_STEP.
+-(void) applyStep:(NSData*)step useAfter:(bool)useAfter descID:(int)descID
+{
+    Model* model = self.model;
+    const uint8_t* bytes = step.bytes;
+    NSUInteger length = step.length;
+    
+    struct UndoStepHeader header;
+    memcpy(&header, bytes, sizeof(header));
+    
+    // Decode the side of every entry that is applied.
+    NSMutableArray* ids     = [[NSMutableArray alloc] init];
+    NSMutableArray* records = [[NSMutableArray alloc] init];
+    NSUInteger offset = sizeof(header);
+    while(offset + sizeof(struct UndoEntryHeader) <= length)
+    {
+        struct UndoEntryHeader entry;
+        memcpy(&entry, bytes + offset, sizeof(entry));
+        offset += sizeof(entry);
+        const uint8_t* before = bytes + offset;
+        offset += entry.beforeLength;
+        
+        uint32_t afterLength;
+        memcpy(&afterLength, bytes + offset, sizeof(afterLength));
+        offset += sizeof(afterLength);
+        const uint8_t* after = bytes + offset;
+        offset += afterLength;
+        
+        uint32_t recordLength = (useAfter) ? afterLength : entry.beforeLength;
+        ComponentRecord* record = (recordLength > 0) ? [ModelArchive recordFromBytes:(useAfter) ? after : before length:recordLength] : nil;
+        [ids addObject:[NSNumber numberWithInt:entry.idNum]];
+        [records addObject:(record) ? (id)record : [NSNull null]];
+    }
+    
+    [model beginTransaction];
+    
+    // Remove the components that did not exist on this side of the step, links first.  A link whose Variables differ from its record is created again below.
+    for(NSUInteger i = 0; i < ids.count; ++i)
+    {
+        Component* compo = [model getComponent:[[ids objectAtIndex:i] intValue]];
+        id record = [records objectAtIndex:i];
+        if([compo isMemberOfClass:[CausalLink class]] &&
+           (record == [NSNull null] ||
+            [record parentID] != [[(CausalLink*)compo parentObject] idNum] ||
+            [record childID]  != [[(CausalLink*)compo childObject] idNum]))
+        {
+            [model deleteCausalLink:[(CausalLink*)compo view]];
+        }
+    }
+    for(NSUInteger i = 0; i < ids.count; ++i)
+    {
+        Component* compo = [model getComponent:[[ids objectAtIndex:i] intValue]];
+        if([records objectAtIndex:i] != [NSNull null])
+        {
+            continue;
+        }
+        if([compo isMemberOfClass:[Variable class]])
+        {
+            [model removeVariable:(Variable*)compo withDetails:nil];
+        }
+        else if([compo isMemberOfClass:[Loop class]])
+        {
+            [model deleteLoop:[(Loop*)compo view]];
+        }
+    }
+    
+    // Create or update the Variables and Loops, then the links between them, so a link is bent to its record after its Variables have moved.
+    for(id record in records)
+    {
+        if(record == [NSNull null] || [record objectType] == CAUSAL_LINK)
+        {
+            continue;
+        }
+        Component* compo = [model getComponent:[record idNum]];
+        if([compo isMemberOfClass:[Variable class]])
+        {
+            [(Variable*)compo applyRecord:record];
+            [model moveVariable:[(Variable*)compo view]];
+        }
+        else if([compo isMemberOfClass:[Loop class]])
+        {
+            [(Loop*)compo applyRecord:record];
+        }
+        else
+        {
+            [model addComponentWithRecord:record];
+        }
+    }
+    for(id record in records)
+    {
+        if(record == [NSNull null] || [record objectType] != CAUSAL_LINK)
+        {
+            continue;
+        }
+        Component* compo = [model getComponent:[record idNum]];
+        if([compo isMemberOfClass:[CausalLink class]])
+        {
+            [(CausalLink*)compo applyRecord:record];
+        }
+        else
+        {
+            [model addComponentWithRecord:record];
+        }
+    }
+    
+    [model commitTransaction:nil];
+    
+    [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID:descID
+                                                               andObjectID:header.objectID
+                                                                andDetails:[NSString stringWithFormat:UNDO_DETAILS, header.descID, (int)ids.count]]];
+}
+
+/// Forgets every step.  Used when a new model is created or opened.
+-(void) clear
+{
+    [self.undoSteps removeAllObjects];
+    [self.redoSteps removeAllObjects];
+    self.byteCount   = 0;
+    self.openRecords = nil;
+    self.openIDs     = nil;
+}
+
+@end
@@ -7,16 +7,22 @@
 //
 
 #import "Component.h"
+#import "ComponentRecord.h"
+#import "ComponentStore.h"
+#import "RecordBuilder.h"
 #import "VariableView.h"
 
 /// A subclass of Component containing the data related to a variable of a causal loop diagram. ex. In a diagram on Childhood obesity, "Fast Food" may be a variable in the model influencing childhood obesity.
 @interface Variable : Component
 
-/// An array of CausalLink objects that point to this variable
-@property NSMutableArray* indegreeLinks;
+/// The CausalLink objects that point to this variable, in the order they were added.  The order of the parents in the variable map.
+@property ComponentStore* indegreeLinks;
 
-/// An array of CausalLink objects that extend from this variable
-@property NSMutableArray* outdegreeLinks;
+/// The CausalLink objects that extend from this variable, in the order they were added.
+@property ComponentStore* outdegreeLinks;
+
+/// The first line of the variable map as it was last exported, encoded as UTF-8.  nil when the name of the variable or any of its parents, or its indegree links have changed since.
+@property NSData* cachedVarMap;
 
 /// Where the text holding the variable name is located in relation to the variable object.
 @property int textPosition;
@@ -26,12 +32,18 @@
 
 -(void) addIndegreeLink:(id) link;
 -(void) addOutdegreeLink:(id) link;
--(id)init:(NSArray*)data;
+-(id)initWithRecord:(ComponentRecord*)record;
+-(ComponentRecord*)createRecord;
+-(void)applyRecord:(ComponentRecord*)record;
+-(void) logImport;
 -(id)initWithLocation:(CGPoint) location;
 -(int) getVariableHeight;
 -(int) getVariableWidth;
 -(void) removeIndgreeLink:(id) link;
 -(void) removeOutdgreeLink:(id) link;
+-(void) invalidateVarMaps;
 -(NSArray*) createVarMap;
+-(void) appendVarMapTo:(RecordBuilder*)builder;
 -(NSString*) createVariableOutputString;
+-(void) appendVariableOutputTo:(RecordBuilder*)builder;
 @end
@@ -14,42 +14,30 @@
 
 @implementation Variable
 
-/// Enum containing the indicies of an array of strings separated by commas in which the different attributes of a varaible in a Vensim mdl file are located.
-enum IndexLocations
-{
-    TYPE    = 0,
-    ID      = 1,
-    NAME    = 2,
-    XCOORD  = 3,
-    YCOORD  = 4,
-    SYMBOL  = 7,
-    TEXTPOS = 11
-};
-
-
 @synthesize indegreeLinks  = _indegreeLinks;
 @synthesize outdegreeLinks = _outdegreeLinks;
+@synthesize cachedVarMap   = _cachedVarMap;
 @synthesize textPosition   = _textPosition;
 @synthesize view           = _view;
 
 
 /// Initializes the Variable when you are loading data from a mdl file.
-/// @param data an array of strings containing all of the data for the variable from a Vensim mdl file.
+/// The view is created but not displayed, the Model adds the views of all imported components at once.
+/// @param record the data for the variable from a Vensim mdl file.
 /// @return a pointer to the newly created Variable.
--(id)init:(NSArray*)data
+-(id)initWithRecord:(ComponentRecord*)record
 {
-    self = [super init];
+    self = [super initWithIDNum:record.idNum];
     if(self)
     {
-        self.objectType     = [[data objectAtIndex:TYPE] integerValue];
-        self.idNum          = [[data objectAtIndex:ID] integerValue];
-        self.textPosition   = [[data objectAtIndex:TEXTPOS] integerValue];
-        self.indegreeLinks  = [[NSMutableArray alloc]init];
-        self.outdegreeLinks = [[NSMutableArray alloc]init];
+        self.objectType     = record.objectType;
+        self.textPosition   = record.textPosition;
+        self.indegreeLinks  = [[ComponentStore alloc]init];
+        self.outdegreeLinks = [[ComponentStore alloc]init];
         
         // Create the view to add to the parent view.
-        self.view = [[VariableView  alloc] initWithFrame:CGRectMake([[data objectAtIndex:XCOORD] integerValue],
-                                                                    [[data objectAtIndex:YCOORD] integerValue],
+        self.view = [[VariableView  alloc] initWithFrame:CGRectMake(record.xcoord,
+                                                                    record.ycoord,
                                                                     VAR_WIDTH,
                                                                     VAR_HEIGHT)
                                                andParent:self];
@@ -58,30 +46,58 @@ enum IndexLocations
         self.view.center = CGPointMake(self.view.frame.origin.x + (VAR_WIDTH/2), self.view.frame.origin.y + (VAR_HEIGHT/2.0));
         
         // Add a border to the variable if it is a boxed variable
-        [self.view setIsBoxed:([[data objectAtIndex:SYMBOL] integerValue] == BOXED_VAR)];
+        [self.view setIsBoxed:(record.symbol == BOXED_VAR)];
         
-        // Set the name of the variable, sanitizing escape characters
-        [self.view setName:[Component sanitizeString:[data objectAtIndex:NAME]]];
+        // Set the name of the variable, escape characters were sanitized when the record was read.
+        [self.view setName:record.name];
         
         // Set the pointer to the parent object.
         [self.view setParent:self];
-
-        // Get the root view controller view and add the Variable's view as a subview.
-        [[[Model sharedModel] getViewControllerView] addSubview:self.view];
-        
-        // Log the import
-        NSString* name     = [NSString stringWithFormat:OBJECT_NAME, self.view.name];
-        NSString* location = [[Model sharedModel]constructLocationDetails:self.view.center];
-        NSString* type     = [NSString stringWithFormat:OBJECT_TYPE,(self.view.isBoxed) ? BOXED_LABEL : NORMAL_LABEL];
-        
-        NSString* details = [NSString stringWithFormat:@"%@ %@ %@", name, type, location];
-        [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID:IMPORTED_VARIABLE
-                                                                   andObjectID:self.idNum
-                                                                    andDetails:details]];
     }
     return self;
 }
 
+/// Creates a record of the current state of the Variable that initWithRecord: turns back into the same Variable.
+/// @return the record of the variable.
+-(ComponentRecord*)createRecord
+{
+    ComponentRecord* record = [[ComponentRecord alloc] init];
+    record.objectType   = VARIABLE;
+    record.idNum        = self.idNum;
+    record.name         = self.view.name;
+    record.xcoord       = (int)lround(self.view.center.x - (VAR_WIDTH/2));
+    record.ycoord       = (int)lround(self.view.center.y - (VAR_HEIGHT/2.0));
+    record.symbol       = (self.view.isBoxed) ? BOXED_VAR : 0;
+    record.textPosition = self.textPosition;
+    return record;
+}
+
+/// Sets the Variable to the state held by a record, keeping its links.  Used when an edit is undone or redone.
+/// The links touching the Variable are not moved.
+/// @param record the record of the variable, created by createRecord.
+-(void)applyRecord:(ComponentRecord*)record
+{
+    self.textPosition = record.textPosition;
+    self.view.center  = CGPointMake(record.xcoord + (VAR_WIDTH/2), record.ycoord + (VAR_HEIGHT/2.0));
+    [self.view setIsBoxed:(record.symbol == BOXED_VAR)];
+    [self.view setName:record.name];
+    [self.view setNeedsDisplay];
+}
+
+/// Logs the import of the Variable with a formatted description of its name, type, and location.
+/// Only used when the event logger is recording imports in verbose mode.
+-(void) logImport
+{
+    NSString* name     = [NSString stringWithFormat:OBJECT_NAME, self.view.name];
+    NSString* location = [self.model constructLocationDetails:self.view.center];
+    NSString* type     = [NSString stringWithFormat:OBJECT_TYPE,(self.view.isBoxed) ? BOXED_LABEL : NORMAL_LABEL];
+    
+    NSString* details = [NSString stringWithFormat:@"%@ %@ %@", name, type, location];
+    [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID:IMPORTED_VARIABLE
+                                                               andObjectID:self.idNum
+                                                                andDetails:details]];
+}
+
 /// Initizlizes the Variable when you are adding a brand new variable.
 /// @param location the location of the new object in the frame.
 /// @return a pointer to the newly created Variable.
@@ -92,8 +108,8 @@ enum IndexLocations
     {
         self.objectType     = VARIABLE;
         self.textPosition   = DEFAULT_TEXT_POS;
-        self.indegreeLinks  = [[NSMutableArray alloc]init];
-        self.outdegreeLinks = [[NSMutableArray alloc]init];
+        self.indegreeLinks  = [[ComponentStore alloc]init];
+        self.outdegreeLinks = [[ComponentStore alloc]init];
         
         self.view = [[VariableView  alloc] initWithFrame:CGRectMake(location.x,
                                                                     location.y,
@@ -109,9 +125,6 @@ enum IndexLocations
         
         // Set the pointer to the parent object.
         [self.view setParent:self];
-    
-        // Get the root view controller view and add the Variable's view as a subview.
-        [[[Model sharedModel] getViewControllerView] addSubview:self.view];
     }
     
     return  self;
@@ -121,14 +134,15 @@ enum IndexLocations
 /// @param link the CausalLink that should be added.
 -(void) addIndegreeLink:(id) link
 {
-    [self.indegreeLinks addObject:link];
+    [self.indegreeLinks addComponent:link];
+    self.cachedVarMap = nil;
 }
 
 /// Add a CausalLink to the list of outdegree links to this variable.
 /// @param link the CausalLink that should be added.
 -(void) addOutdegreeLink:(id) link
 {
-    [self.outdegreeLinks addObject:link];
+    [self.outdegreeLinks addComponent:link];
 }
 
 /// Gets the height of the variable view.
@@ -149,14 +163,25 @@ enum IndexLocations
 /// @param link the CausalLink that should be deleted.
 -(void) removeIndgreeLink:(id) link
 {
-    [self.indegreeLinks removeObject:link];
+    [self.indegreeLinks removeComponent:link];
+    self.cachedVarMap = nil;
 }
 
 /// Removes a CausalLink from the list of outdegree links for this variable.
 /// @param link the CausalLink that should be deleted.
 -(void) removeOutdgreeLink:(id) link
 {
-    [self.outdegreeLinks removeObject:link];
+    [self.outdegreeLinks removeComponent:link];
+}
+
+/// Discards the cached variable map of this variable and of every variable it points to, since all of them contain its name.
+-(void) invalidateVarMaps
+{
+    self.cachedVarMap = nil;
+    for(CausalLink* link in self.outdegreeLinks)
+    {
+        [link.childObject setCachedVarMap:nil];
+    }
 }
 
 /// Constructs the variable map, identifying which variables influence the current variable.
@@ -168,33 +193,43 @@ enum IndexLocations
 /// @return an array that contains the three lines that represent the map for the variable.
 -(NSArray*) createVarMap
 {
+    RecordBuilder* builder = [[RecordBuilder alloc] init];
+    [self appendVarMapTo:builder];
     
-    NSString* construction = self.view.name;
-    construction = [construction stringByAppendingString:FUNCTION_OF];
+    // Construct the array.
+    NSArray* results = [[NSArray alloc]initWithObjects:[builder string],
+                                                       TILDE,
+                                                       TILDE_BAR,
+                                                       nil];
+    return results;
+}
+
+/// Appends the first line of the variable map to a RecordBuilder.  The remaining two lines are always TILDE and TILDE_BAR.
+/// Example of the output created:
+/// Big Variable  = A FUNCTION OF( variable 1,variable 2)
+/// @param builder the builder to append the line to.
+-(void) appendVarMapTo:(RecordBuilder*)builder
+{
+    [builder appendString:self.view.name];
+    [builder appendString:FUNCTION_OF];
 
     // Iterate over the indegree links to get the names of where the links where derived.
-    for(int i=0; i < self.indegreeLinks.count; ++i)
+    bool isFirst = YES;
+    for(CausalLink* l in self.indegreeLinks)
     {
-        CausalLink* l = (CausalLink*)[self.indegreeLinks objectAtIndex:i];
         Variable* parent = l.parentObject;
         
-        // Add the name of the parent of the link.
-        construction = [construction stringByAppendingString:parent.view.name];
+        // Separate the names of the parents with commas.
+        if(!isFirst)
+            [builder appendString:COMMA];
+        isFirst = NO;
         
-        // Determine if a comma needs to be added as long as there are more indegree links.
-        if(i < self.indegreeLinks.count-1)
-            construction = [construction stringByAppendingString:COMMA];
+        // Add the name of the parent of the link.
+        [builder appendString:parent.view.name];
     }
     
     // Add closed paren.
-    construction = [construction stringByAppendingString:CLOSED_PAREN];
-    
-    // Construct the array.
-    NSArray* results = [[NSArray alloc]initWithObjects:construction,
-                                                       TILDE,
-                                                       TILDE_BAR,
-                                                       nil];
-    return results;
+    [builder appendString:CLOSED_PAREN];
 }
 
 /// Constructs the output string for a Variable.
@@ -203,33 +238,42 @@ enum IndexLocations
 /// [Object Type],[Object id],[Object Name],[X Location],[Y Location],?,?,[Variable Type],3,0,0,[Text Position],0,0,0
 /// @return the string of data for the variable.
 -(NSString*) createVariableOutputString
+{
+    RecordBuilder* builder = [[RecordBuilder alloc] init];
+    [self appendVariableOutputTo:builder];
+    return [builder string];
+}
+
+/// Appends the output record for a Variable to a RecordBuilder.
+/// @see createVariableOutputString for the pattern of the record.
+/// @param builder the builder to append the record to.
+-(void) appendVariableOutputTo:(RecordBuilder*)builder
 {
     // Initialize with the type.
-    NSString* result = [NSString stringWithFormat:@"%d", VARIABLE];
+    [builder appendInt:VARIABLE];
     
     // Add the id number.
-    result = [result stringByAppendingString:[NSString stringWithFormat:@",%d", self.idNum]];
+    [builder appendField:self.idNum];
     
     // Add the name.
     /// @todo I do not put the extra characters vensim uses for "
-    result = [result stringByAppendingString:[NSString stringWithFormat:@",%@", self.view.name]];
+    [builder appendLiteral:","];
+    [builder appendString:self.view.name];
     
     // Add x coordinate.
-    result = [result stringByAppendingString:[NSString stringWithFormat:@",%d", (int)self.view.center.x]];
+    [builder appendField:(int)self.view.center.x];
     
     // Add y coordinate.
-    result = [result stringByAppendingString:[NSString stringWithFormat:@",%d", (int)self.view.center.y]];
+    [builder appendField:(int)self.view.center.y];
     
     // Add whether or not the variable is boxed.
     if(self.view.isBoxed)
-        result = [result stringByAppendingString:BOXED_VAR_NUMS];
+        [builder appendString:BOXED_VAR_NUMS];
     else
-        result = [result stringByAppendingString:NORMAL_VAR_NUMS];
+        [builder appendString:NORMAL_VAR_NUMS];
     
     // Add misc. defaults.
-    result = [result stringByAppendingString:VAR_DEFAULTS];
-
-    return result;
+    [builder appendString:VAR_DEFAULTS];
 }
 
 @end
@@ -17,10 +17,10 @@
 @property UIColor* boxColor;
 
 /// Whether the variable is boxed.
-@property bool isBoxed;
+@property (nonatomic) bool isBoxed;
 
 /// The name of the variable.
-@property NSString* name;
+@property (nonatomic) NSString* name;
 
 /// Pointer to the parent of this view.
 @property id parent;
@@ -11,6 +11,7 @@
 #import "Model.h"
 #import "ModelSectionViewController.h"
 #import "NewCausalLink.h"
+#import "Variable.h"
 #import "VariableView.h"
 
 @implementation VariableView
@@ -49,6 +50,39 @@
     return self;
 }
 
+/// Sets the name of the variable.  The name is part of the sketch record of the variable, and of the variable maps of it and its children.
+/// @param name the new name of the variable.
+-(void)setName:(NSString*)name
+{
+    _name = name;
+    [(Variable*)self.parent invalidateRecord];
+    [(Variable*)self.parent invalidateVarMaps];
+}
+
+/// Sets whether the variable is boxed.  Part of the sketch record of the variable.
+/// @param isBoxed true if the variable is boxed.
+-(void)setIsBoxed:(bool)isBoxed
+{
+    _isBoxed = isBoxed;
+    [(Variable*)self.parent invalidateRecord];
+}
+
+/// Moves the view.  The location is part of the sketch record of the variable.  This is an overridden method.
+/// @param center the new center of the view.
+-(void)setCenter:(CGPoint)center
+{
+    [super setCenter:center];
+    [(Variable*)self.parent invalidateRecord];
+}
+
+/// Moves or resizes the view.  The location is part of the sketch record of the variable.  This is an overridden method.
+/// @param frame the new frame of the view.
+-(void)setFrame:(CGRect)frame
+{
+    [super setFrame:frame];
+    [(Variable*)self.parent invalidateRecord];
+}
+
 /// Draws the receiver’s image within the passed-in rectangle.  This is an overridden method.
 /// @param rect the frame of the view in which objects can be drawn. 
 -(void)drawRect:(CGRect)rect
@@ -71,11 +105,15 @@
           alignment: NSTextAlignmentCenter];
 }
 
-/// Logs event at the beginning of moving the variable.
+/// Logs event at the beginning of moving the variable, and opens an undo step for the move.
 /// @param touches the set of touch events registered by the application.
 /// @param event the UIEvent that fired the the method call.
 -(void)touchesBegan:(NSSet *)touches withEvent:(UIEvent *)event
-{    
+{
+    UndoHistory* history = [Model sharedModel].history;
+    [history beginStep];
+    [history willChangeComponent:(Variable*)self.parent];
+    
     [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID:BEGIN_VAR_MOVE
                                                                andObjectID:[(Variable*)self.parent idNum]
                                                                 andDetails:[[Model sharedModel] constructLocationDetails:[touches.anyObject locationInView:self.superview]]]];
@@ -98,7 +136,7 @@
                                                                 andDetails:[[Model sharedModel] constructLocationDetails:self.center]]];
 }
 
-/// Logs event at the end of moving the variable.
+/// Logs event at the end of moving the variable, and closes the undo step of the move.
 /// @param touches the set of touch events registered by the application.
 /// @param event the UIEvent that fired the the method call.
 -(void)touchesEnded:(NSSet *)touches withEvent:(UIEvent *)event
@@ -106,6 +144,15 @@
     [[EventLogger sharedEventLogger]addEvent:[[Event alloc] initWithDescID:END_VAR_MOVE
                                                                andObjectID:[(Variable*)self.parent idNum]
                                                                 andDetails:[[Model sharedModel] constructLocationDetails:[touches.anyObject locationInView:self.superview]]]];
+    [[Model sharedModel].history endStepWithDescID:END_VAR_MOVE andObjectID:[(Variable*)self.parent idNum]];
+}
+
+/// Closes the undo step of the move when the touch is taken over by a gesture, such as a tap.  A step that did not move the variable is dropped.
+/// @param touches the set of touch events registered by the application.
+/// @param event the UIEvent that fired the the method call.
+-(void)touchesCancelled:(NSSet *)touches withEvent:(UIEvent *)event
+{
+    [[Model sharedModel].history endStepWithDescID:END_VAR_MOVE andObjectID:[(Variable*)self.parent idNum]];
 }
 
 /// Will open up the menu of options for the object on a single tap.
@@ -184,7 +231,9 @@
             if(parent != nil && child != nil && parent != child)
             {
                 // Add new causalLink
+                [[Model sharedModel].history beginStep];
                 int idNum = [[Model sharedModel] addCasualLinkWithParent:parent andChild:child];
+                [[Model sharedModel].history endStepWithDescID:CAUSAL_LINK_ADDED andObjectID:idNum];
                 NSString* details = [[NSString alloc] initWithFormat:PARENT_CHILD,
                                                                     parent.view.name,
                                                                     parent.idNum,
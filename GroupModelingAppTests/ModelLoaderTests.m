@@ -0,0 +1,181 @@
+//
+//  ModelLoaderTests.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "Constants.h"
+#import "ModelCache.h"
+#import "ModelLoader.h"
+#import "TestAssertions.h"
+
+/// The location of smallModelTest.mdl, passed as the first argument of the driver.
+static NSString* fixturePath = nil;
+
+/// The sha1 hash of smallModelTest.mdl.
+static const uint8_t fixtureHash[20] = { 0x2a, 0x8b, 0x93, 0x8f, 0xa8, 0x51, 0x84, 0x70, 0x03, 0x69,
+                                         0x32, 0x48, 0x2e, 0xd2, 0x4b, 0x34, 0x01, 0xf0, 0xeb, 0xc1 };
+
+/// Creates an empty folder in the temporary directory, so the tests never touch the cache of the app.
+/// @param name the name of the folder.
+/// @return the path of the folder.
+static NSString* temporaryFolder(NSString* name)
+{
+    NSString* path = [NSTemporaryDirectory() stringByAppendingPathComponent:name];
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+    [[NSFileManager defaultManager] createDirectoryAtPath:path withIntermediateDirectories:YES attributes:nil error:nil];
+    return path;
+}
+
+/// Creates a loader for a local file that uses its own cache.
+/// @param path the path of the file to load.
+/// @param cache the cache the loader should use.
+/// @return the loader.
+static ModelLoader* loaderForPath(NSString* path, ModelCache* cache)
+{
+    ModelLoader* loader = [[ModelLoader alloc] initWithURL:[NSURL fileURLWithPath:path]];
+    loader.cache = cache;
+    return loader;
+}
+
+/// Runs the main run loop until a condition is true or a second has passed.
+/// @param done checked after each pass of the run loop.
+static void runMainLoopUntil(bool (^done)(void))
+{
+    NSDate* timeout = [NSDate dateWithTimeIntervalSinceNow:1.0];
+    while(!done() && [timeout timeIntervalSinceNow] > 0)
+    {
+        [[NSRunLoop mainRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+}
+
+/// The background stages fetch, hash, and parse a local mdl file, and the second load of the same file comes from the cache.
+static void testRunStagesOnLocalFile(void)
+{
+    ModelCache* cache = [[ModelCache alloc] initWithDirectory:temporaryFolder(@"ModelLoaderTests") maxBytes:1024 * 1024];
+    ModelLoader* loader = loaderForPath(fixturePath, cache);
+
+    NSMutableArray* stages = [[NSMutableArray alloc] init];
+    bool loaded = [loader runStages:^(int stage, float fraction) {
+        if(stages.count == 0 || [[stages lastObject] intValue] != stage)
+        {
+            [stages addObject:[NSNumber numberWithInt:stage]];
+        }
+    }];
+    CHECK(loaded);
+    CHECK(loader.error == nil);
+    CHECK(!loader.isFromCache);
+    CHECK(loader.data == nil);
+    CHECK(loader.graph.records.count == 10);
+    CHECK([loader.fileHash isEqualToData:[NSData dataWithBytes:fixtureHash length:sizeof(fixtureHash)]]);
+
+    NSArray* expected = [NSArray arrayWithObjects:[NSNumber numberWithInt:LOAD_FETCH], [NSNumber numberWithInt:LOAD_HASH], [NSNumber numberWithInt:LOAD_PARSE], nil];
+    CHECK([stages isEqualToArray:expected]);
+
+    ModelLoader* second = loaderForPath(fixturePath, cache);
+    CHECK([second runStages:nil]);
+    CHECK(second.isFromCache);
+    CHECK(second.graph.records.count == 10);
+    CHECK([[[second.graph.records objectAtIndex:0] name] isEqualToString:@"variable 1"]);
+}
+
+/// A file that does not exist fails the fetch stage with an error.
+static void testRunStagesOnMissingFile(void)
+{
+    ModelCache* cache = [[ModelCache alloc] initWithDirectory:temporaryFolder(@"ModelLoaderTestsMissing") maxBytes:1024 * 1024];
+    ModelLoader* loader = loaderForPath([NSTemporaryDirectory() stringByAppendingPathComponent:@"missing.mdl"], cache);
+    CHECK(![loader runStages:nil]);
+    CHECK(loader.error != nil);
+    CHECK(loader.graph == nil);
+}
+
+/// A cancelled loader stops after the fetch stage.
+static void testCancelledRunStages(void)
+{
+    ModelCache* cache = [[ModelCache alloc] initWithDirectory:temporaryFolder(@"ModelLoaderTestsCancel") maxBytes:1024 * 1024];
+    ModelLoader* loader = loaderForPath(fixturePath, cache);
+    [loader cancel];
+    CHECK(![loader runStages:nil]);
+    CHECK(loader.fileHash == nil);
+    CHECK(loader.graph == nil);
+}
+
+/// A full load reports every stage on the main thread and then calls the completion block.
+static void testLoadWithProgress(void)
+{
+    ModelCache* cache = [[ModelCache alloc] initWithDirectory:temporaryFolder(@"ModelLoaderTestsLoad") maxBytes:1024 * 1024];
+    ModelLoader* loader = loaderForPath(fixturePath, cache);
+
+    __block int lastStage = -1;
+    __block bool offMainThread = false;
+    __block ModelLoader* completed = nil;
+    [loader loadWithProgress:^(int stage, float fraction) {
+        offMainThread |= ![NSThread isMainThread];
+        lastStage = stage;
+    } completion:^(ModelLoader* finished) {
+        offMainThread |= ![NSThread isMainThread];
+        completed = finished;
+    }];
+    runMainLoopUntil(^bool{ return completed != nil; });
+
+    CHECK(completed == loader);
+    CHECK(!offMainThread);
+    CHECK(lastStage == LOAD_COMMIT);
+    CHECK(loader.graph.records.count == 10);
+}
+
+/// Once a load is cancelled, progress that was already queued for the main thread is dropped along with the completion block, even when the stages finished before the cancel.
+static void testCancelledLoadWithProgress(void)
+{
+    ModelCache* cache = [[ModelCache alloc] initWithDirectory:temporaryFolder(@"ModelLoaderTestsCancelLoad") maxBytes:1024 * 1024];
+    ModelLoader* loader = loaderForPath(fixturePath, cache);
+
+    __block int updates = 0;
+    __block bool completed = false;
+    [loader loadWithProgress:^(int stage, float fraction) {
+        ++updates;
+    } completion:^(ModelLoader* finished) {
+        completed = true;
+    }];
+
+    // Wait for the stages to finish on the load queue.  Every update and the completion are then already queued for the main thread, which has not run yet, so only the checks made on the main thread can drop them.
+    dispatch_sync(loader.loadQueue, ^{});
+    [loader cancel];
+
+    // Spin the main run loop until a block queued after the cancel runs, so everything the load queued before it has run as well.
+    __block bool drained = false;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        drained = true;
+    });
+    runMainLoopUntil(^bool{ return drained; });
+
+    CHECK(drained);
+    CHECK(updates == 0);
+    CHECK(!completed);
+}
+
+/// Runs the tests of the background stages of an import against a local file, without a UI.
+/// @param argc the number of arguments.
+/// @param argv the path of smallModelTest.mdl.
+/// @return 0 if every test passed.
+int main(int argc, const char* argv[])
+{
+    @autoreleasepool
+    {
+        if(argc < 2)
+        {
+            NSLog(@"Usage: %s <path to smallModelTest.mdl>", argv[0]);
+            return 2;
+        }
+        fixturePath = [NSString stringWithUTF8String:argv[1]];
+
+        RUN_TEST(testRunStagesOnLocalFile);
+        RUN_TEST(testRunStagesOnMissingFile);
+        RUN_TEST(testCancelledRunStages);
+        RUN_TEST(testLoadWithProgress);
+        RUN_TEST(testCancelledLoadWithProgress);
+        return finishTests();
+    }
+}
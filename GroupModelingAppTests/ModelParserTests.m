@@ -0,0 +1,201 @@
+//
+//  ModelParserTests.m
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "Constants.h"
+#import "ModelParser.h"
+#import "TestAssertions.h"
+
+/// The location of smallModelTest.mdl, passed as the first argument of the driver.
+static NSString* fixturePath = nil;
+
+/// The longest a model of 10000 components may take to parse with no views attached, in seconds.
+static const NSTimeInterval largeModelParseLimit = 0.5;
+
+/// Removes the line ending left on a line of a file saved with Windows line endings.
+/// smallModelTest.mdl has them, and the parser keeps the carriage return the same way the original importer did.
+/// @param line a line read by the parser.
+/// @return the line without a trailing carriage return.
+static NSString* withoutLineEnding(NSString* line)
+{
+    return [line stringByTrimmingCharactersInSet:[NSCharacterSet newlineCharacterSet]];
+}
+
+/// Creates the sketch section of a model with a repeating pattern of two Variables, a CausalLink between them, and a Loop.
+/// @param groups the number of times the pattern is repeated.
+/// @return the contents of the file.
+static NSData* syntheticModel(int groups)
+{
+    NSMutableString* file = [[NSMutableString alloc] init];
+    [file appendString:@"\\\\\\---/// Sketch information - do not modify anything except names\n"];
+    [file appendString:@"V300  Do not put anything below this section - it will be ignored\n"];
+    [file appendString:@"*View 1\n"];
+    [file appendString:@"$0-255-0,0,Times New Roman|12||0-0-0|0-0-0|0-0-255|-1--1--1|-1--1--1|96,96,100,0\n"];
+    for(int i = 0; i < groups; ++i)
+    {
+        int idNum = i * 4 + 1;
+        [file appendFormat:@"10,%d,variable %d,%d,%d,32,11,0,3,0,0,0,0,0,0\n", idNum, idNum, i % 1000, i / 1000];
+        [file appendFormat:@"10,%d,variable %d,%d,%d,32,11,3,3,0,0,0,0,0,0\n", idNum + 1, idNum + 1, i % 1000 + 50, i / 1000];
+        [file appendFormat:@"1,%d,%d,%d,1,0,45,0,2,65,0,-1--1--1,|12||0-0-0,1|(%d,%d)|\n", idNum + 2, idNum, idNum + 1, i % 1000 + 25, i / 1000];
+        [file appendFormat:@"12,%d,0,%d,%d,20,20,4,7,0,0,-1,0,0,0\n", idNum + 3, i % 1000, i / 1000 + 30];
+        [file appendFormat:@"R%d\n", idNum + 3];
+    }
+    [file appendString:@"///---\\\\\\\n"];
+    return [file dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+/// The records of smallModelTest.mdl come out in file order with their ids, names, and attributes.
+static void testSmallModelRecords(void)
+{
+    NSData* data = [NSData dataWithContentsOfFile:fixturePath];
+    CHECK(data != nil);
+
+    ModelGraph* graph = [[[ModelParser alloc] init] parseData:data];
+    CHECK(graph != nil);
+    CHECK(graph.records.count == 10);
+    if(graph.records.count != 10)
+    {
+        return;
+    }
+
+    int expectedIDs[10]   = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    int expectedTypes[10] = { VARIABLE, VARIABLE, VARIABLE, CAUSAL_LINK, CAUSAL_LINK, CAUSAL_LINK, CAUSAL_LINK, LOOP, LOOP, CAUSAL_LINK };
+    int counts[3] = { 0, 0, 0 };
+    for(NSUInteger i = 0; i < graph.records.count; ++i)
+    {
+        ComponentRecord* record = [graph.records objectAtIndex:i];
+        CHECK(record.idNum == expectedIDs[i]);
+        CHECK(record.objectType == expectedTypes[i]);
+        counts[0] += (record.objectType == VARIABLE)    ? 1 : 0;
+        counts[1] += (record.objectType == CAUSAL_LINK) ? 1 : 0;
+        counts[2] += (record.objectType == LOOP)        ? 1 : 0;
+    }
+    CHECK(counts[0] == 3);
+    CHECK(counts[1] == 5);
+    CHECK(counts[2] == 2);
+
+    // Variables keep their names, with the escape characters removed, and their locations.
+    ComponentRecord* variable1 = [graph.records objectAtIndex:0];
+    ComponentRecord* variable2 = [graph.records objectAtIndex:1];
+    ComponentRecord* big       = [graph.records objectAtIndex:2];
+    CHECK([variable1.name isEqualToString:@"variable 1"]);
+    CHECK([variable2.name isEqualToString:@"variable 2"]);
+    CHECK([big.name isEqualToString:@"\"Big Variable\""]);
+    CHECK(variable1.xcoord == 436 && variable1.ycoord == 287);
+    CHECK(variable1.symbol == NORMAL_VAR);
+    CHECK(big.symbol == BOXED_VAR);
+
+    // Links refer to their Variables by id and keep the location of their handle.
+    ComponentRecord* link = [graph.records objectAtIndex:3];
+    CHECK(link.parentID == 1 && link.childID == 3);
+    CHECK(link.polarity == PLUS);
+    CHECK(link.lineThickness == LIGHT_BOLD);
+    CHECK(link.xcoord == 545 && link.ycoord == 386);
+    CHECK(!link.hasColor);
+    CHECK(![link hasTimeDelay]);
+    ComponentRecord* lastLink = [graph.records objectAtIndex:9];
+    CHECK(lastLink.parentID == 2 && lastLink.childID == 3);
+    CHECK(lastLink.polarity == MINUS);
+    CHECK(lastLink.lineThickness == NORMAL);
+
+    // The name of a loop is read from the line after it, and is not read as a component of its own.
+    ComponentRecord* loop1 = [graph.records objectAtIndex:7];
+    ComponentRecord* loop2 = [graph.records objectAtIndex:8];
+    CHECK([withoutLineEnding(loop1.name) isEqualToString:@"B1"]);
+    CHECK([withoutLineEnding(loop2.name) isEqualToString:@"B2"]);
+    CHECK(loop1.symbol == CLOCKWISE);
+    CHECK(loop2.symbol == COUNTER_CLOCKWISE);
+    CHECK(loop1.xcoord == 701 && loop1.ycoord == 223);
+}
+
+/// The control and default parameters of smallModelTest.mdl are kept so they can be written back out.
+static void testSmallModelParameters(void)
+{
+    ModelGraph* graph = [[[ModelParser alloc] init] parseData:[NSData dataWithContentsOfFile:fixturePath]];
+    CHECK(graph.controlParams.count > 0);
+    CHECK([[graph.controlParams objectAtIndex:0] hasPrefix:SIM_CONTROL_PARAMS_PREFIX]);
+    bool hasFinalTime = false;
+    for(NSString* line in graph.controlParams)
+    {
+        hasFinalTime |= [withoutLineEnding(line) isEqualToString:@"FINAL TIME  = 100"];
+    }
+    CHECK(hasFinalTime);
+    CHECK([graph.defaultParams hasPrefix:DEFAULT_PARAMS_PREFIX]);
+    CHECK(graph.largestIDNum == 0);
+}
+
+/// A large sketch is parsed in chunks across all cores well within the time limit, and comes out the same as a single chunk parse.
+static void testChunkedParseMatchesSequential(void)
+{
+    int groups = 2500;
+    NSData* data = syntheticModel(groups);
+
+    NSDate* start = [NSDate date];
+    ModelGraph* graph = [[[ModelParser alloc] init] parseData:data];
+    NSTimeInterval elapsed = -[start timeIntervalSinceNow];
+    NSLog(@"Parsed %d components in %.1f ms", groups * 4, elapsed * 1000.0);
+    CHECK(elapsed < largeModelParseLimit);
+    CHECK(graph.records.count == (NSUInteger)groups * 4);
+
+    bool endFound = false;
+    ModelGraph* sequential = [[[ModelParser alloc] init] parseSketch:[data bytes] from:0 to:[data length] endFound:&endFound];
+    CHECK(endFound);
+    CHECK(sequential.records.count == graph.records.count);
+    if(sequential.records.count != graph.records.count)
+    {
+        return;
+    }
+
+    for(NSUInteger i = 0; i < graph.records.count; ++i)
+    {
+        ComponentRecord* record   = [graph.records objectAtIndex:i];
+        ComponentRecord* expected = [sequential.records objectAtIndex:i];
+        CHECK(record.idNum == (int)i + 1);
+        CHECK(record.idNum == expected.idNum);
+        CHECK(record.objectType == expected.objectType);
+        CHECK([record.name isEqualToString:expected.name]);
+        if(record.objectType == LOOP)
+        {
+            CHECK([record.name isEqualToString:[NSString stringWithFormat:@"R%d", record.idNum]]);
+        }
+        if(record.objectType == CAUSAL_LINK)
+        {
+            CHECK([record hasTimeDelay]);
+        }
+    }
+}
+
+/// A cancelled parse returns nil.
+static void testCancelledParse(void)
+{
+    ModelParser* parser = [[ModelParser alloc] init];
+    parser.isCancelled = YES;
+    CHECK([parser parseData:syntheticModel(100)] == nil);
+}
+
+/// Runs the tests of the parse stage of an import, which only depends on Foundation.
+/// @param argc the number of arguments.
+/// @param argv the path of smallModelTest.mdl.
+/// @return 0 if every test passed.
+int main(int argc, const char* argv[])
+{
+    @autoreleasepool
+    {
+        if(argc < 2)
+        {
+            NSLog(@"Usage: %s <path to smallModelTest.mdl>", argv[0]);
+            return 2;
+        }
+        fixturePath = [NSString stringWithUTF8String:argv[1]];
+
+        RUN_TEST(testSmallModelRecords);
+        RUN_TEST(testSmallModelParameters);
+        RUN_TEST(testChunkedParseMatchesSequential);
+        RUN_TEST(testCancelledParse);
+        return finishTests();
+    }
+}
@@ -0,0 +1,42 @@
+//
+//  TestAssertions.h
+//  GroupModelingApp
+//
+//  Created by agent on 10/17/26.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef GroupModelingApp_TestAssertions_h
+#define GroupModelingApp_TestAssertions_h
+
+#import <Foundation/Foundation.h>
+
+/// The number of checks that have failed in the test driver.
+static int testFailures = 0;
+
+/// Records a failure with the location and text of the condition if the condition is false.  The test keeps running.
+#define CHECK(condition) \
+    do { \
+        if(!(condition)) \
+        { \
+            ++testFailures; \
+            NSLog(@"FAIL %s:%d: %s", __FILE__, __LINE__, #condition); \
+        } \
+    } while(0)
+
+/// Runs a test function and logs its name, so a failure can be matched to the test it came from.
+#define RUN_TEST(test) \
+    do { \
+        NSLog(@"Running %s", #test); \
+        @autoreleasepool { test(); } \
+    } while(0)
+
+/// Ends the test driver.
+/// @return the exit status of the driver, 0 if every check passed.
+static inline int finishTests(void)
+{
+    NSLog(@"%s", (testFailures == 0) ? "All checks passed" : "Checks failed");
+    return (testFailures == 0) ? 0 : 1;
+}
+
+#endif
@@ -16,12 +16,14 @@ EVENT_LOG     = 'EventLog'
 GID	      = 'gid'
 LOG_DIRECTORY = './Event_Logs/'
 MODEL_FILE    = 'ModelFile'
+MODEL_DELTA   = 'ModelDelta'
 NAME	      = 'name'
 RESULTS	      = 'results'
 UNKNOWN_MDL   = 'unknown.mdl' 
 URL	      = 'url'
 
 import base64, hashlib, httplib, json, os, sys, urllib, urllib2
+import reconstructModel
 from collections import namedtuple
 from array import *
 
@@ -72,7 +74,7 @@ print "Processed " + str(len(dropboxHashes)) + " mdl or txt files in " + dropbox
 print "Retrieving data from the database"
 connection = httplib.HTTPSConnection(PARSE_ADDRESS, PORT)
 
-params = urllib.urlencode({"order":"gid,createdAt", "keys":"UserID,EndingHash,gid,EventLog,ModelFile"})
+params = urllib.urlencode({"order":"gid,createdAt", "keys":"UserID,EndingHash,gid,EventLog,ModelFile,ModelDelta"})
 connection.connect()
 connection.request('GET', '/' + API_VERSION + '/classes/' + TABLE + '?%s' % params,'', {
 	"X-Parse-Application-Id": APP_ID,
@@ -97,6 +99,7 @@ print "There are " + str(len(results)) + " records in the database"
 
 id = results[0][GID]
 fileCount = 1		#Keeps track of the number of files we have parsed for the current GID.
+models = {}		#The contents of every model downloaded so far by ending hash, used to rebuild the models uploaded as deltas.
 
 # Iterate over all of the records in the table
 for i, record in enumerate(results):
@@ -108,16 +111,22 @@ for i, record in enumerate(results):
 
 	# Get the log file url, model url, and ending hash
 	logURL   = record[EVENT_LOG][URL]
-	modelURL = record[MODEL_FILE][URL]
 	endHash  = record[ENDING_HASH][BASE64]
 	
 	# Download the contents of the log located at the url
 	downloadedLogFile = urllib2.urlopen(logURL)
 	log = downloadedLogFile.read()
 
-	# Download the contents of the model located at the url
-	downloadedModelFile = urllib2.urlopen(modelURL)
-	model = downloadedModelFile.read() 
+	# Download the contents of the model located at the url.
+	# A record holding a delta is rebuilt from the earlier model it was created from.
+	if MODEL_DELTA in record:
+		delta = urllib2.urlopen(record[MODEL_DELTA][URL]).read()
+		baseHash, deltaHash = reconstructModel.deltaHashes(delta)
+		model = reconstructModel.applyDelta(models[baseHash], delta)
+	else:
+		downloadedModelFile = urllib2.urlopen(record[MODEL_FILE][URL])
+		model = downloadedModelFile.read() 
+	models[endHash] = model
 
 	# Create the directory for each global id if it does not exist
 	fileDir = LOG_DIRECTORY + 'id' + str(id) + '/'
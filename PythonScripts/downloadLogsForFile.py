@@ -15,11 +15,13 @@ ENDING_HASH   = 'EndingHash'
 EVENT_LOG     = 'EventLog'
 GID	      = 'gid'
 MODEL_FILE    = 'ModelFile'
+MODEL_DELTA   = 'ModelDelta'
 RESULTS	      = 'results' 
 URL	      = 'url'
 UNKNOWN_MDL   = 'unknown.mdl'
 
 import base64, hashlib, httplib, json, os, sys, urllib, urllib2
+import reconstructModel
 from collections import namedtuple
 from array import *
 
@@ -105,7 +107,7 @@ try:
 	globalID = results[0][GID]
 
 	params = urllib.urlencode({"where": json.dumps({
-		"gid": globalID}), "order":"createdAt", "keys":"EndingHash,EventLog,ModelFile"})
+		"gid": globalID}), "order":"createdAt", "keys":"EndingHash,EventLog,ModelFile,ModelDelta"})
 	connection.connect()
 	connection.request('GET', '/' + API_VERSION + '/classes/' + TABLE + '?%s' % params,'', {
 		"X-Parse-Application-Id": APP_ID,
@@ -120,20 +122,27 @@ except:
 try:
 	results = data[RESULTS]
 	print "There are " + str(len(results)) + " records in the database linked to " + fileName
+	models = {}	#The contents of every model downloaded so far by ending hash, used to rebuild the models uploaded as deltas.
 	for i, record in enumerate(results):
 		print "Processing record id number " + str(i+1)
 		
 		# Get the log file url, model url, and ending hash
 		logURL   = record[EVENT_LOG][URL]
-		modelURL = record[MODEL_FILE][URL]
 		endHash  = record[ENDING_HASH][BASE64]
 
 		# Download the contents of the log and model file
 		downloadedFile = urllib2.urlopen(logURL)
 		log = downloadedFile.read()
 
-		downloadedFile = urllib2.urlopen(modelURL)
-		model = downloadedFile.read()
+		# A record holding a delta is rebuilt from the earlier model it was created from.
+		if MODEL_DELTA in record:
+			delta = urllib2.urlopen(record[MODEL_DELTA][URL]).read()
+			baseHash, deltaHash = reconstructModel.deltaHashes(delta)
+			model = reconstructModel.applyDelta(models[baseHash], delta)
+		else:
+			downloadedFile = urllib2.urlopen(record[MODEL_FILE][URL])
+			model = downloadedFile.read()
+		models[endHash] = model
 
 		# Create directory to store these files
 		dir = "id" + str(globalID) + '/'
@@ -0,0 +1,192 @@
+#! /usr/bin/env python
+
+# Generates synthetic Vensim mdl files for benchmarking the import and export of models.
+# The output has the same structure as the files Vensim saves: the variable maps, the
+# simulation control parameters, and the sketch information with every Variable,
+# CausalLink, and Loop.
+#
+# ex. ./generateModel.py --variables 20000 --links 25000 --loops 500 -o large.mdl
+
+# Constants for the Vensim sketch records
+CAUSAL_LINK    = 1
+VARIABLE       = 10
+LOOP           = 12
+PLUS           = 43
+MINUS          = 45
+BOXED_VAR      = 3
+CLOCKWISE      = 4
+COUNTER_CLOCK  = 5
+NORMAL         = 0
+LIGHT_BOLD     = 12
+
+# Constants for the layout of the generated model
+CANVAS_WIDTH   = 4000
+CANVAS_HEIGHT  = 4000
+VAR_WIDTH      = 32
+VAR_HEIGHT     = 11
+LOOP_SIZE      = 20
+NAME_CHARS     = 'abcdefghijklmnopqrstuvwxyz'
+
+# Fixed sections of the file
+ENCODING       = '{UTF-8}'
+CONTROL_PARAMS = '''********************************************************
+	.Control
+********************************************************~
+		Simulation Control Parameters
+	|
+
+FINAL TIME  = 100
+	~	Month
+	~	The final time for the simulation.
+	|
+
+INITIAL TIME  = 0
+	~	Month
+	~	The initial time for the simulation.
+	|
+
+SAVEPER  = 
+        TIME STEP
+	~	Month [0,?]
+	~	The frequency with which output is stored.
+	|
+
+TIME STEP  = 1
+	~	Month [0,?]
+	~	The time step for the simulation.
+	|
+'''
+SKETCH_INFO    = '\\\\\\---/// Sketch information - do not modify anything except names'
+V300           = 'V300  Do not put anything below this section - it will be ignored'
+VIEW           = '*View 1'
+DEFAULT_PARAMS = '$192-192-192,0,Times New Roman|12||0-0-0|0-0-0|0-0-255|-1--1--1|-1--1--1|72,72,100,0'
+END_OF_SKETCH  = '///---\\\\\\'
+
+import argparse, random, sys
+
+parser = argparse.ArgumentParser(description='Generate a synthetic Vensim mdl file.')
+parser.add_argument('--variables', type=int, default=1000, help='number of variables')
+parser.add_argument('--links', type=int, default=None, help='number of causal links, overrides --density')
+parser.add_argument('--density', type=float, default=1.5, help='causal links per variable when --links is not given')
+parser.add_argument('--loops', type=int, default=50, help='number of feedback loop labels')
+parser.add_argument('--name-length', type=int, default=12, help='length of each variable name')
+parser.add_argument('--curved', type=float, default=0.5, help='fraction of links with a curved handle')
+parser.add_argument('--seed', type=int, default=0, help='seed for the random generator so files can be regenerated')
+parser.add_argument('--app-trailer', action='store_true', help='end with the largest id line written by the app instead of the Vensim trailer')
+parser.add_argument('-o', '--output', default=None, help='file to write, defaults to stdout')
+args = parser.parse_args()
+
+if args.variables < 2 and (args.links or args.density > 0):
+	print('At least two variables are needed to create causal links')
+	sys.exit(1)
+
+random.seed(args.seed)
+numLinks = args.links if args.links is not None else int(args.variables * args.density)
+
+###############################################################################
+# Create the variables with unique names, spread out over the canvas.
+variables = []
+names = set()
+for i in range(args.variables):
+	name = ''.join(random.choice(NAME_CHARS) for _ in range(args.name_length))
+	while name in names:
+		name = ''.join(random.choice(NAME_CHARS) for _ in range(args.name_length))
+	names.add(name)
+	variables.append({
+		'id':     i + 1,
+		'name':   name,
+		'x':      random.randint(VAR_WIDTH, CANVAS_WIDTH - VAR_WIDTH),
+		'y':      random.randint(VAR_HEIGHT, CANVAS_HEIGHT - VAR_HEIGHT),
+		'boxed':  random.random() < 0.2,
+		'parents': [],
+	})
+
+###############################################################################
+# Create the causal links between distinct variables.
+nextID = len(variables) + 1
+links = []
+for i in range(numLinks):
+	parent, child = random.sample(variables, 2)
+	child['parents'].append(parent['name'])
+
+	# A straight link has its handle half way between the two variables.
+	hx = (parent['x'] + child['x']) // 2
+	hy = (parent['y'] + child['y']) // 2
+	if random.random() < args.curved:
+		hx += random.randint(-100, 100)
+		hy += random.randint(-100, 100)
+
+	links.append({
+		'id':       nextID,
+		'parent':   parent['id'],
+		'child':    child['id'],
+		'polarity': random.choice([PLUS, MINUS]),
+		'bold':     random.random() < 0.1,
+		'delay':    random.random() < 0.1,
+		'color':    random.random() < 0.1,
+		'hx':       hx,
+		'hy':       hy,
+	})
+	nextID += 1
+
+###############################################################################
+# Create the loop labels.
+loops = []
+for i in range(args.loops):
+	loops.append({
+		'id':        nextID,
+		'name':      random.choice(['B', 'R']) + str(i + 1),
+		'x':         random.randint(LOOP_SIZE, CANVAS_WIDTH - LOOP_SIZE),
+		'y':         random.randint(LOOP_SIZE, CANVAS_HEIGHT - LOOP_SIZE),
+		'clockwise': random.random() < 0.5,
+	})
+	nextID += 1
+
+###############################################################################
+# Write the file.
+lines = [ENCODING]
+
+# Variable maps
+for v in variables:
+	lines.append(v['name'] + '  = A FUNCTION OF( ' + ','.join(v['parents']) + ')')
+	lines.append('\t~\t')
+	lines.append('\t~\t\t|')
+	lines.append('')
+
+lines.append(CONTROL_PARAMS)
+lines.append(SKETCH_INFO)
+lines.append(V300)
+lines.append(VIEW)
+lines.append(DEFAULT_PARAMS)
+
+# Sketch records, interleaved the way Vensim orders objects as they are drawn.
+records = []
+for v in variables:
+	records.append((v['id'], '%d,%d,%s,%d,%d,%d,%d,%d,3,0,0,0,0,0,0' % (
+		VARIABLE, v['id'], v['name'], v['x'], v['y'], VAR_WIDTH, VAR_HEIGHT, BOXED_VAR if v['boxed'] else 0)))
+for l in links:
+	delay = 64 if l['delay'] else 0
+	color = '%d-%d-%d' % (random.randint(0, 255), random.randint(0, 255), random.randint(0, 255)) if l['color'] else '-1--1--1'
+	records.append((l['id'], '%d,%d,%d,%d,1,0,%d,%d,2,%d,0,%s,|12||0-0-0,1|(%d,%d)|' % (
+		CAUSAL_LINK, l['id'], l['parent'], l['child'], l['polarity'], LIGHT_BOLD if l['bold'] else NORMAL, delay, color, l['hx'], l['hy'])))
+for o in loops:
+	records.append((o['id'], '%d,%d,0,%d,%d,%d,%d,%d,7,0,0,-1,0,0,0\n%s' % (
+		LOOP, o['id'], o['x'], o['y'], LOOP_SIZE, LOOP_SIZE, CLOCKWISE if o['clockwise'] else COUNTER_CLOCK, o['name'])))
+for idNum, record in sorted(records):
+	lines.append(record)
+
+if args.app_trailer:
+	lines.append('-%d' % (nextID - 1))
+else:
+	lines.append(END_OF_SKETCH)
+	lines.append(':L<%^E!@')
+	lines.append('9:Current')
+
+output = '\n'.join(lines) + '\n'
+if args.output:
+	out = open(args.output, 'w')
+	out.write(output)
+	out.close()
+	sys.stderr.write('Wrote %d variables, %d links, and %d loops to %s\n' % (len(variables), len(links), len(loops), args.output))
+else:
+	sys.stdout.write(output)
@@ -0,0 +1,128 @@
+#! /usr/bin/env python
+
+# Rebuilds the mdl files uploaded as deltas.
+# When the server already holds the file a session started from, the app uploads a
+# ModelDelta listing only the components that were added, removed, or changed instead
+# of the whole ModelFile. Applying each delta in order to the last full file gives back
+# every version byte for byte, which is checked against the hashes stored in the delta.
+#
+# ex. ./reconstructModel.py base.mdl 1.delta 2.delta -o latest.mdl
+#     ./reconstructModel.py base.mdl 1.delta 2.delta --all versions/
+
+# Constants for the delta format, see ModelVersion in the app
+DELTA_HEADER  = b'{GMA delta 1}'
+DELTA_PREFIX  = b'!'
+DELTA_REMOVE  = b'-'
+DELTA_CHANGE  = b'~'
+DELTA_ADD     = b'+'
+DELTA_TRAILER = b'='
+
+# Constants for the sketch section of an exported mdl file
+VIEW          = b'*View 1'
+LOOP_PREFIX   = b'12,'
+
+import argparse, base64, hashlib, os, re, sys
+
+class Version:
+	"""An exported mdl file split into the lines before the records, the records by id, and the lines after."""
+	def __init__(self, prefix, ids, records, trailer):
+		self.prefix  = prefix
+		self.ids     = ids
+		self.records = records
+		self.trailer = trailer
+
+	def data(self):
+		return b'\n'.join([self.prefix] + [self.records[i] for i in self.ids] + [self.trailer])
+
+def hashOf(data):
+	return base64.b64encode(hashlib.sha1(data).digest())
+
+def parseModel(data):
+	"""Splits a full mdl file exported by the app into a Version."""
+	lines = data.split(b'\n')
+	view = lines.index(VIEW)
+
+	# The default parameters line directly follows the view line.
+	prefix = b'\n'.join(lines[:view + 2])
+	ids, records = [], {}
+	i = view + 2
+	while i < len(lines) and not re.match(br'^-\d+$', lines[i]):
+		# A Loop record is followed by a line with its name.
+		count = 2 if lines[i].startswith(LOOP_PREFIX) else 1
+		record = b'\n'.join(lines[i:i + count])
+		idNum = int(record.split(b',')[1])
+		ids.append(idNum)
+		records[idNum] = record
+		i += count
+	return Version(prefix, ids, records, b'\n'.join(lines[i:]))
+
+def deltaHashes(delta):
+	"""Gets the base64 hashes of the file a delta applies to and the file it produces."""
+	lines = delta.split(b'\n', 3)
+	if lines[0] != DELTA_HEADER:
+		raise ValueError('Not a model delta')
+	return lines[1], lines[2]
+
+def applyDelta(base, delta):
+	"""Applies a delta to the bytes of the file it was created from and returns the bytes of the new file."""
+	baseHash, endHash = deltaHashes(delta)
+	if hashOf(base) != baseHash:
+		raise ValueError('The delta does not apply to this file')
+
+	version = parseModel(base)
+	added = []
+	offset = len(b'\n'.join(delta.split(b'\n', 3)[:3])) + 1
+	while offset < len(delta):
+		end = delta.index(b'\n', offset)
+		operation, value = delta[offset:offset + 1], delta[offset + 1:end]
+		offset = end + 1
+		if operation == DELTA_REMOVE:
+			idNum = int(value)
+			version.ids.remove(idNum)
+			del version.records[idNum]
+			continue
+
+		# Every other entry is followed by a block of the given length and a newline.
+		block = delta[offset:offset + int(value)]
+		offset += int(value) + 1
+		if operation == DELTA_PREFIX:
+			version.prefix = block
+		elif operation == DELTA_TRAILER:
+			version.trailer = block
+		else:
+			idNum = int(block.split(b',')[1])
+			if operation == DELTA_ADD:
+				added.append(idNum)
+			version.records[idNum] = block
+
+	# New components are always written after the ones that already existed.
+	version.ids.extend(added)
+	data = version.data()
+	if hashOf(data) != endHash:
+		raise ValueError('The rebuilt file does not match the hash in the delta')
+	return data
+
+if __name__ == '__main__':
+	parser = argparse.ArgumentParser(description='Rebuild an uploaded model from the last full file and its deltas.')
+	parser.add_argument('base', help='the last full model file uploaded')
+	parser.add_argument('deltas', nargs='*', help='the deltas uploaded after it, in order')
+	parser.add_argument('-o', '--output', help='where to write the final version, stdout if not given')
+	parser.add_argument('--all', metavar='DIRECTORY', help='also write every intermediate version to this directory')
+	args = parser.parse_args()
+
+	model = open(args.base, 'rb').read()
+	if args.all and not os.path.exists(args.all):
+		os.makedirs(args.all)
+	for i, path in enumerate(args.deltas):
+		model = applyDelta(model, open(path, 'rb').read())
+		if args.all:
+			out = open(os.path.join(args.all, '%d.mdl' % (i + 1)), 'wb')
+			out.write(model)
+			out.close()
+
+	if args.output:
+		out = open(args.output, 'wb')
+		out.write(model)
+		out.close()
+	else:
+		getattr(sys.stdout, 'buffer', sys.stdout).write(model)